@@ -0,0 +1,258 @@
+/*
+	Name: 			Michael Lausdahl Fuglsang
+	email:			mfugls11
+	Study No.:		20112699
+
+	Code also available at:
+	https://github.com/Malakahh/Ap-exam-part-2
+*/
+
+#ifndef _CHEBYSHEV_POLYNOMIAL
+#define _CHEBYSHEV_POLYNOMIAL
+
+#include <cstddef>
+#include <vector>
+#include <utility>
+#include <stdexcept>
+#include <algorithm>
+#include <type_traits>
+#include <initializer_list>
+
+#include "Polynomial.h"
+#include "PolynomialKernels.h"
+
+/*
+	Polynomial on an interval [lower, upper], stored as coefficients of the Chebyshev polynomials T_k,
+	sum c[k] T_k(t) with t = (2x - lower - upper) / (upper - lower) in [-1, 1].
+
+	High degree fits that lose their accuracy in the monomial basis stay well conditioned in the Chebyshev
+	basis, so they can be kept in float or double. Evaluation uses Clenshaw, with the same AVX-512 and AVX2
+	kernels for float and double as Polynomial::ValueAtRange.
+*/
+template <typename C> class ChebyshevPolynomial
+{
+	static_assert(std::is_floating_point<C>::value, "Chebyshev polynomials need floating point coefficients");
+
+private:
+	std::vector<C> coefficients;
+	C lower;
+	C upper;
+
+	void CheckInterval() const
+	{
+		if (!(this->lower < this->upper))
+		{
+			throw std::invalid_argument("The interval must have lower < upper");
+		}
+	}
+
+	//Multiplication settings of Polynomial<C>, for the basis changes
+	static PolynomialKernels::Multiplier CurrentMultiplier()
+	{
+		const auto thresholds = Polynomial<C>::GetMultiplicationThresholds();
+
+		return { thresholds.karatsuba, thresholds.fft, GetDefaultExecutor() };
+	}
+
+	//Maps x to t = x * scale + shift
+	C MapScale() const { return C(2) / (this->upper - this->lower); }
+	C MapShift() const { return -(this->upper + this->lower) / (this->upper - this->lower); }
+
+public:
+	/*
+		Creates a Chebyshev polynomial from its coefficients, lowest first, on [lower, upper].
+		Throws std::invalid_argument if lower isn't below upper.
+	*/
+	ChebyshevPolynomial(std::initializer_list<C> list, const C lower = -1, const C upper = 1) : coefficients(list), lower(lower), upper(upper)
+	{
+		this->CheckInterval();
+	}
+
+	ChebyshevPolynomial(std::vector<C> coefficients, const C lower = -1, const C upper = 1) : coefficients(std::move(coefficients)), lower(lower), upper(upper)
+	{
+		this->CheckInterval();
+	}
+
+	/*
+		Approximates f on [lower, upper] with size coefficients, from its values at the Chebyshev points.
+		f is sampled at the next power of two points, and the coefficients come out of a DCT in O(n log n).
+		Polynomials of degree below size are reproduced up to rounding.
+	*/
+	template <typename F> static ChebyshevPolynomial<C> FromFunction(const F& f, const std::size_t size, const C lower = -1, const C upper = 1)
+	{
+		std::size_t n = 1;
+		while (n < size)
+		{
+			n <<= 1;
+		}
+
+		auto points = std::vector<C>(n);
+		PolynomialKernels::ChebyshevPoints(points.data(), n);
+
+		for (auto& x : points)
+		{
+			x = f((x * (upper - lower) + lower + upper) / 2);
+		}
+
+		return FromValues(points, size, lower, upper);
+	}
+
+	/*
+		Converts a polynomial to the Chebyshev basis on [lower, upper].
+		The polynomial is mapped to t with Polynomial::Affine and changed to the Chebyshev basis by divide and
+		conquer on top of fast multiplication, O(n log^2 n) with FFT, see PolynomialKernels::MonomialToChebyshev.
+	*/
+	static ChebyshevPolynomial<C> FromPolynomial(const Polynomial<C>& p, const C lower = -1, const C upper = 1)
+	{
+		//p(x) with x = t * (upper - lower) / 2 + (lower + upper) / 2
+		auto q = p;
+		if (lower != C(-1) || upper != C(1))
+		{
+			q.Affine((upper - lower) / 2, (lower + upper) / 2);
+		}
+
+		auto monomial = std::vector<C>(q.Size());
+		auto data = q.Data();
+		for (std::size_t i = 0; i < monomial.size(); i++)
+		{
+			monomial[i] = data != nullptr ? data[i] : q.GetCoefficient(static_cast<unsigned int>(i));
+		}
+
+		return ChebyshevPolynomial<C>(PolynomialKernels::MonomialToChebyshev(monomial.data(), monomial.size(), CurrentMultiplier()), lower, upper);
+	}
+
+	//Number of coefficients, i.e. degree + 1.
+	std::size_t Size() const { return this->coefficients.size(); }
+
+	//Contiguous coefficient buffer, lowest first.
+	const C* Data() const { return this->coefficients.data(); }
+
+	//Lower end of the interval.
+	C Lower() const { return this->lower; }
+
+	//Upper end of the interval.
+	C Upper() const { return this->upper; }
+
+	//Gets the coefficient of T_k.
+	C GetCoefficient(const std::size_t k) const
+	{
+		if (k >= this->coefficients.size())
+		{
+			throw std::out_of_range("Index out of bounds");
+		}
+
+		return this->coefficients[k];
+	}
+
+	//Sets the coefficient of T_k, growing the polynomial if needed.
+	void SetCoefficient(const C value, const std::size_t k)
+	{
+		if (k >= this->coefficients.size())
+		{
+			this->coefficients.resize(k + 1, C(0));
+		}
+
+		this->coefficients[k] = value;
+	}
+
+	//Valuates the polynomial at a given point.
+	C ValueAt(const C x) const
+	{
+		return PolynomialKernels::Clenshaw(this->coefficients.data(), this->coefficients.size(), x * this->MapScale() + this->MapShift());
+	}
+
+	//Valuates the polynomial at every point in [first, last), writing the results to out.
+	void ValueAtRange(const C* first, const C* last, C* out) const
+	{
+		const auto count = this->coefficients.size();
+		const auto n = static_cast<std::size_t>(last - first);
+		const auto scale = this->MapScale();
+		const auto shift = this->MapShift();
+
+		//Split the points across the executor when there is enough work
+		auto grain = std::max<std::size_t>(64, PolynomialKernels::parallelWorkThreshold / std::max<std::size_t>(count, 1));
+
+		ParallelFor(GetDefaultExecutor(), n, grain, [&](const std::size_t begin, const std::size_t end) {
+			PolynomialKernels::ClenshawBatch(this->coefficients.data(), count, scale, shift, first + begin, out + begin, end - begin);
+		});
+	}
+
+	/*
+		Converts to the monomial basis, in x rather than t, by divide and conquer like FromPolynomial, O(n log^2 n).
+		This is the ill conditioned direction for high degrees, see the class description.
+	*/
+	Polynomial<C> ToPolynomial() const
+	{
+		Polynomial<C> p(std::initializer_list<C>{});
+
+		{
+			const auto monomial = PolynomialKernels::ChebyshevToMonomial(this->coefficients.data(), this->coefficients.size(), CurrentMultiplier());
+
+			auto m = p.Mutate();
+			m.Resize(monomial.size());
+			std::copy(monomial.begin(), monomial.end(), m.Data());
+		}
+
+		if (this->lower != C(-1) || this->upper != C(1))
+		{
+			p.Affine(this->MapScale(), this->MapShift());
+		}
+
+		return p;
+	}
+
+	//Computes the derivative, on the same interval.
+	ChebyshevPolynomial<C> CalculateDerivative() const
+	{
+		const auto size = this->coefficients.size();
+		auto res = std::vector<C>(size > 1 ? size - 1 : 0);
+		PolynomialKernels::ChebyshevDerivative(this->coefficients.data(), size, res.data());
+
+		//dt/dx
+		const auto scale = this->MapScale();
+		for (auto& c : res)
+		{
+			c *= scale;
+		}
+
+		return ChebyshevPolynomial<C>(std::move(res), this->lower, this->upper);
+	}
+
+	//Computes the antiderivative which is 0 at the lower end of the interval.
+	ChebyshevPolynomial<C> CalculateAntiderivative() const
+	{
+		const auto size = this->coefficients.size();
+		auto res = std::vector<C>(size + 1);
+		PolynomialKernels::ChebyshevIntegrate(this->coefficients.data(), size, res.data());
+
+		//dx/dt
+		const auto scale = (this->upper - this->lower) / 2;
+		for (auto& c : res)
+		{
+			c *= scale;
+		}
+
+		return ChebyshevPolynomial<C>(std::move(res), this->lower, this->upper);
+	}
+
+	//Computes the integral over [a, b].
+	C CalculateIntegral(const C a, const C b) const
+	{
+		const auto antiderivative = this->CalculateAntiderivative();
+
+		return antiderivative.ValueAt(b) - antiderivative.ValueAt(a);
+	}
+
+private:
+	//Transforms the values at the Chebyshev points, keeping size coefficients
+	static ChebyshevPolynomial<C> FromValues(const std::vector<C>& values, const std::size_t size, const C lower, const C upper)
+	{
+		auto coefficients = std::vector<C>(values.size());
+		PolynomialKernels::ChebyshevFromValues(values.data(), values.size(), coefficients.data(), GetDefaultExecutor());
+		coefficients.resize(size);
+
+		return ChebyshevPolynomial<C>(std::move(coefficients), lower, upper);
+	}
+};
+
+#endif
@@ -0,0 +1,191 @@
+/*
+	Name: 			Michael Lausdahl Fuglsang
+	email:			mfugls11
+	Study No.:		20112699
+
+	Code also available at:
+	https://github.com/Malakahh/Ap-exam-part-2
+*/
+
+#ifndef _COEFFICIENT_BUFFER
+#define _COEFFICIENT_BUFFER
+
+#include <vector>
+#include <algorithm>
+#include <utility>
+
+#include "MemoryResource.h"
+
+/*
+	Contiguous coefficient storage keeping up to N coefficients inline, and moving to a std::vector beyond that.
+	Small polynomials are created, copied and moved without allocating, while large ones
+	don't pay for a second indirection. Heap coefficients come from a MemoryResource, see ResourceAllocator.
+	Meant for arithmetic types, inline coefficients past the size are left uninitialized.
+*/
+template <typename C, std::size_t N> class CoefficientBuffer
+{
+private:
+	C local[N];
+	std::size_t localSize;
+	bool isLocal;
+
+	std::vector<C, ResourceAllocator<C>> heap;
+
+	//Frees the heap coefficients, keeping the resource
+	void ReleaseHeap()
+	{
+		std::vector<C, ResourceAllocator<C>>(this->heap.get_allocator()).swap(this->heap);
+	}
+
+	//Moves the inline coefficients to the heap, making room for at least capacity of them
+	void Spill(const std::size_t capacity)
+	{
+		this->heap.reserve(std::max(capacity, 2 * N));
+		this->heap.assign(this->local, this->local + this->localSize);
+		this->isLocal = false;
+	}
+
+public:
+	//Creates an empty buffer taking heap memory from the given resource
+	explicit CoefficientBuffer(MemoryResource* resource = GetDefaultResource()) : localSize(0), isLocal(true), heap(resource) {}
+
+	//Copies take the calling thread's default resource
+	CoefficientBuffer(const CoefficientBuffer& b) : localSize(0), isLocal(true)
+	{
+		*this = b;
+	}
+
+	//Moves keep the resource of b
+	CoefficientBuffer(CoefficientBuffer&& b) : localSize(0), isLocal(true), heap(b.heap.get_allocator())
+	{
+		*this = std::move(b);
+	}
+
+	//Copies shrink back to inline storage when they fit
+	CoefficientBuffer& operator=(const CoefficientBuffer& b)
+	{
+		if (this != &b)
+		{
+			this->assign(b.begin(), b.end());
+		}
+
+		return *this;
+	}
+
+	//Leaves the source empty. The heap coefficients are only handed over if both buffers use the same resource.
+	CoefficientBuffer& operator=(CoefficientBuffer&& b)
+	{
+		if (this == &b)
+		{
+			return *this;
+		}
+
+		if (b.isLocal)
+		{
+			std::copy(b.local, b.local + b.localSize, this->local);
+			this->localSize = b.localSize;
+			this->isLocal = true;
+			this->ReleaseHeap();
+		}
+		else
+		{
+			this->heap = std::move(b.heap);
+			this->isLocal = false;
+			b.ReleaseHeap();
+		}
+
+		b.localSize = 0;
+		b.isLocal = true;
+
+		return *this;
+	}
+
+	//Copies the coefficients of a vector
+	CoefficientBuffer& operator=(const std::vector<C>& v)
+	{
+		this->assign(v.begin(), v.end());
+
+		return *this;
+	}
+
+	template <typename It> void assign(It first, It last)
+	{
+		const auto count = static_cast<std::size_t>(std::distance(first, last));
+
+		if (count <= N)
+		{
+			std::copy(first, last, this->local);
+			this->localSize = count;
+			this->isLocal = true;
+			this->ReleaseHeap();
+		}
+		else
+		{
+			this->heap.assign(first, last);
+			this->isLocal = false;
+		}
+	}
+
+	std::size_t size() const { return this->isLocal ? this->localSize : this->heap.size(); }
+	bool empty() const { return this->size() == 0; }
+
+	C* data() { return this->isLocal ? this->local : this->heap.data(); }
+	const C* data() const { return this->isLocal ? this->local : this->heap.data(); }
+
+	C* begin() { return this->data(); }
+	C* end() { return this->data() + this->size(); }
+	const C* begin() const { return this->data(); }
+	const C* end() const { return this->data() + this->size(); }
+
+	C& operator[](const std::size_t i) { return this->data()[i]; }
+	const C& operator[](const std::size_t i) const { return this->data()[i]; }
+
+	//Changes the number of coefficients, new coefficients get the given value
+	void resize(const std::size_t size, const C value = C(0))
+	{
+		if (this->isLocal)
+		{
+			if (size <= N)
+			{
+				std::fill(this->local + std::min(this->localSize, size), this->local + size, value);
+				this->localSize = size;
+				return;
+			}
+
+			this->Spill(size);
+		}
+
+		this->heap.resize(size, value);
+	}
+
+	void push_back(const C value)
+	{
+		if (this->isLocal)
+		{
+			if (this->localSize < N)
+			{
+				this->local[this->localSize++] = value;
+				return;
+			}
+
+			this->Spill(N + 1);
+		}
+
+		this->heap.push_back(value);
+	}
+
+	void clear()
+	{
+		this->localSize = 0;
+		this->isLocal = true;
+		this->ReleaseHeap();
+	}
+
+	//Resource the heap coefficients come from
+	MemoryResource* GetResource() const
+	{
+		return this->heap.get_allocator().GetResource();
+	}
+};
+
+#endif
@@ -0,0 +1,276 @@
+/*
+	Name: 			Michael Lausdahl Fuglsang
+	email:			mfugls11
+	Study No.:		20112699
+
+	Code also available at:
+	https://github.com/Malakahh/Ap-exam-part-2
+*/
+
+#include "Executor.h"
+
+/*******
+******** 	InlineExecutor
+********/
+
+void InlineExecutor::Submit(std::function<void()> task)
+{
+	task();
+}
+
+bool InlineExecutor::RunPendingTask()
+{
+	//Tasks run as they are submitted, so nothing is ever pending
+	return false;
+}
+
+std::size_t InlineExecutor::Concurrency() const
+{
+	return 1;
+}
+
+/*******
+******** 	ThreadPool
+********/
+
+thread_local ThreadPool* ThreadPool::currentPool = nullptr;
+thread_local std::size_t ThreadPool::currentIndex = 0;
+
+ThreadPool::ThreadPool(const std::size_t threadCount) : pending(0), nextQueue(0), stopping(false)
+{
+	const auto count = std::max<std::size_t>(threadCount, 1);
+
+	for (std::size_t i = 0; i < count; i++)
+	{
+		this->workers.push_back(std::make_unique<Worker>());
+	}
+
+	for (std::size_t i = 0; i < count; i++)
+	{
+		this->threads.emplace_back(&ThreadPool::WorkerLoop, this, i);
+	}
+}
+
+ThreadPool::~ThreadPool()
+{
+	{
+		std::lock_guard<std::mutex> lock(this->sleepGuard);
+		this->stopping = true;
+	}
+
+	this->wakeUp.notify_all();
+
+	for (auto& t : this->threads)
+	{
+		t.join();
+	}
+}
+
+void ThreadPool::Submit(std::function<void()> task)
+{
+	//Workers keep their own tasks, other threads spread them out
+	auto index = currentPool == this ? currentIndex : this->nextQueue++ % this->workers.size();
+
+	//Counted before the task is published, so taking it can never decrement pending below zero
+	{
+		std::lock_guard<std::mutex> lock(this->sleepGuard);
+		this->pending++;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(this->workers[index]->guard);
+		this->workers[index]->tasks.push_back(std::move(task));
+	}
+
+	this->wakeUp.notify_one();
+}
+
+bool ThreadPool::RunPendingTask()
+{
+	std::function<void()> task;
+
+	if ((currentPool == this && this->TryPop(currentIndex, task)) || this->TrySteal(currentPool == this ? currentIndex : 0, task))
+	{
+		task();
+		return true;
+	}
+
+	return false;
+}
+
+std::size_t ThreadPool::Concurrency() const
+{
+	return this->workers.size();
+}
+
+//Takes the newest task from the back of a worker's own queue
+bool ThreadPool::TryPop(const std::size_t index, std::function<void()>& task)
+{
+	auto& worker = *this->workers[index];
+	std::lock_guard<std::mutex> lock(worker.guard);
+
+	if (worker.tasks.empty())
+	{
+		return false;
+	}
+
+	task = std::move(worker.tasks.back());
+	worker.tasks.pop_back();
+	this->pending--;
+
+	return true;
+}
+
+//Takes the oldest task from the front of another worker's queue
+bool ThreadPool::TrySteal(const std::size_t thief, std::function<void()>& task)
+{
+	const auto count = this->workers.size();
+
+	for (std::size_t i = 1; i <= count; i++)
+	{
+		auto& worker = *this->workers[(thief + i) % count];
+		std::lock_guard<std::mutex> lock(worker.guard);
+
+		if (!worker.tasks.empty())
+		{
+			task = std::move(worker.tasks.front());
+			worker.tasks.pop_front();
+			this->pending--;
+
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void ThreadPool::WorkerLoop(const std::size_t index)
+{
+	currentPool = this;
+	currentIndex = index;
+
+	while (true)
+	{
+		std::function<void()> task;
+
+		if (this->TryPop(index, task) || this->TrySteal(index, task))
+		{
+			task();
+			continue;
+		}
+
+		std::unique_lock<std::mutex> lock(this->sleepGuard);
+		this->wakeUp.wait(lock, [this]() { return this->stopping || this->pending > 0; });
+
+		if (this->stopping && this->pending == 0)
+		{
+			return;
+		}
+	}
+}
+
+/*******
+******** 	Default executor
+********/
+
+namespace
+{
+	std::atomic<Executor*> defaultExecutor(nullptr);
+}
+
+Executor& GetDefaultExecutor()
+{
+	auto executor = defaultExecutor.load(std::memory_order_acquire);
+
+	if (executor == nullptr)
+	{
+		static ThreadPool pool;
+		return pool;
+	}
+
+	return *executor;
+}
+
+void SetDefaultExecutor(Executor* executor)
+{
+	defaultExecutor.store(executor, std::memory_order_release);
+}
+
+Executor& GetPolicyExecutor(const ExecutionPolicy& policy)
+{
+	if (!policy.parallel)
+	{
+		//Stateless, so one instance serves all threads
+		static InlineExecutor inlineExecutor;
+		return inlineExecutor;
+	}
+
+	return policy.executor != nullptr ? *policy.executor : GetDefaultExecutor();
+}
+
+/*******
+******** 	TaskGroup
+********/
+
+TaskGroup::TaskGroup(Executor& executor) : executor(executor), pending(0) {}
+
+TaskGroup::~TaskGroup()
+{
+	this->Drain();
+}
+
+void TaskGroup::Run(std::function<void()> task)
+{
+	this->pending++;
+
+	this->executor.Submit([this, task]() {
+		try
+		{
+			task();
+		}
+		catch (...)
+		{
+			std::lock_guard<std::mutex> lock(this->errorGuard);
+			if (!this->error)
+			{
+				this->error = std::current_exception();
+			}
+		}
+
+		//Under the lock, so the group can't be destroyed between the decrement and the notification
+		std::lock_guard<std::mutex> lock(this->doneGuard);
+		if (--this->pending == 0)
+		{
+			this->done.notify_all();
+		}
+	});
+}
+
+void TaskGroup::Drain()
+{
+	while (this->pending > 0)
+	{
+		if (!this->executor.RunPendingTask())
+		{
+			//Nothing left to help with, so sleep until the running tasks of the group finish
+			std::unique_lock<std::mutex> lock(this->doneGuard);
+			this->done.wait(lock, [this]() { return this->pending == 0; });
+		}
+	}
+
+	//The last task notifies under the lock, so taking it makes sure the task is done with the group
+	std::lock_guard<std::mutex> lock(this->doneGuard);
+}
+
+void TaskGroup::Wait()
+{
+	this->Drain();
+
+	std::lock_guard<std::mutex> lock(this->errorGuard);
+	if (this->error)
+	{
+		auto e = this->error;
+		this->error = nullptr;
+		std::rethrow_exception(e);
+	}
+}
@@ -0,0 +1,209 @@
+/*
+	Name: 			Michael Lausdahl Fuglsang
+	email:			mfugls11
+	Study No.:		20112699
+
+	Code also available at:
+	https://github.com/Malakahh/Ap-exam-part-2
+*/
+
+#ifndef _EXECUTOR
+#define _EXECUTOR
+
+#include <functional>
+#include <vector>
+#include <deque>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <exception>
+#include <algorithm>
+
+/*
+	Interface for running tasks, used by Polynomial for its parallel work.
+	Implement it to plug Polynomial into an existing task system.
+*/
+class Executor
+{
+public:
+	virtual ~Executor() = default;
+
+	//Runs a task, possibly on another thread.
+	virtual void Submit(std::function<void()> task) = 0;
+
+	/*
+		Runs one task that has been submitted but not started yet, if any, on the calling thread.
+		Used by threads waiting for tasks, so that waiting inside a task can't deadlock.
+	*/
+	virtual bool RunPendingTask() = 0;
+
+	//Number of tasks that can run at the same time.
+	virtual std::size_t Concurrency() const = 0;
+};
+
+/*
+	Executor running every task synchronously on the submitting thread.
+*/
+class InlineExecutor : public Executor
+{
+public:
+	void Submit(std::function<void()> task) override;
+	bool RunPendingTask() override;
+	std::size_t Concurrency() const override;
+};
+
+/*
+	Work-stealing thread pool.
+	Every worker has its own task queue. Tasks submitted from a worker go to the back of its own queue,
+	which it works through from the back, while idle workers steal from the front of the other queues.
+*/
+class ThreadPool : public Executor
+{
+private:
+	struct Worker
+	{
+		std::mutex guard;
+		std::deque<std::function<void()>> tasks;
+	};
+
+	std::vector<std::unique_ptr<Worker>> workers;
+	std::vector<std::thread> threads;
+
+	//Used for putting idle workers to sleep
+	std::mutex sleepGuard;
+	std::condition_variable wakeUp;
+
+	std::atomic<std::size_t> pending;
+	std::atomic<std::size_t> nextQueue;
+	bool stopping;
+
+	//The pool and worker index of the current thread, if it is a worker
+	static thread_local ThreadPool* currentPool;
+	static thread_local std::size_t currentIndex;
+
+	bool TryPop(const std::size_t index, std::function<void()>& task);
+	bool TrySteal(const std::size_t thief, std::function<void()>& task);
+	void WorkerLoop(const std::size_t index);
+
+public:
+	//Creates a pool with the given number of worker threads, by default one per hardware thread.
+	explicit ThreadPool(const std::size_t threadCount = std::max(1u, std::thread::hardware_concurrency()));
+
+	ThreadPool(const ThreadPool&) = delete;
+	ThreadPool& operator=(const ThreadPool&) = delete;
+
+	//Finishes all submitted tasks, then stops the workers.
+	~ThreadPool();
+
+	void Submit(std::function<void()> task) override;
+	bool RunPendingTask() override;
+	std::size_t Concurrency() const override;
+};
+
+/*
+	Gets the executor used by Polynomial operations.
+	By default this is a ThreadPool with one worker per hardware thread.
+*/
+Executor& GetDefaultExecutor();
+
+/*
+	Sets the executor used by Polynomial operations. The executor must outlive its use.
+	Passing nullptr restores the default thread pool.
+*/
+void SetDefaultExecutor(Executor* executor);
+
+/*
+	Execution policy for the Polynomial operations that take one, in the style of std::execution.
+	Use Execution::seq to run on the calling thread, and Execution::par to split the work across
+	the default executor, or across a given one with Execution::par.On(executor).
+*/
+struct ExecutionPolicy
+{
+	bool parallel;
+	Executor* executor;
+
+	//The same policy on the given executor.
+	ExecutionPolicy On(Executor& e) const { return { this->parallel, &e }; }
+};
+
+namespace Execution
+{
+	const ExecutionPolicy seq = { false, nullptr };
+	const ExecutionPolicy par = { true, nullptr };
+}
+
+/*
+	Gets the executor a policy runs its work on: an InlineExecutor for sequential policies,
+	otherwise the executor of the policy, or the default executor if it has none.
+*/
+Executor& GetPolicyExecutor(const ExecutionPolicy& policy);
+
+/*
+	Group of tasks that can be waited for together.
+	Exceptions thrown by tasks are rethrown from Wait.
+*/
+class TaskGroup
+{
+private:
+	Executor& executor;
+	std::atomic<std::size_t> pending;
+
+	//Signalled when pending reaches zero
+	std::mutex doneGuard;
+	std::condition_variable done;
+
+	std::mutex errorGuard;
+	std::exception_ptr error;
+
+	//Waits without rethrowing
+	void Drain();
+
+public:
+	explicit TaskGroup(Executor& executor);
+
+	TaskGroup(const TaskGroup&) = delete;
+	TaskGroup& operator=(const TaskGroup&) = delete;
+
+	~TaskGroup();
+
+	//Submits a task to the executor as part of this group.
+	void Run(std::function<void()> task);
+
+	//Waits for all tasks in the group, helping out with pending tasks meanwhile.
+	void Wait();
+};
+
+/*
+	Calls body(begin, end) over [0, count) split into chunks of at least grain elements.
+	Small inputs, or executors without concurrency, run synchronously on the calling thread.
+*/
+template <typename F> void ParallelFor(Executor& executor, const std::size_t count, const std::size_t grain, const F& body)
+{
+	const auto concurrency = executor.Concurrency();
+
+	if (count <= grain || concurrency <= 1)
+	{
+		body(std::size_t(0), count);
+		return;
+	}
+
+	const auto chunks = std::min(count / std::max<std::size_t>(grain, 1), 4 * concurrency);
+	const auto chunkSize = (count + chunks - 1) / chunks;
+
+	TaskGroup group(executor);
+
+	for (auto begin = chunkSize; begin < count; begin += chunkSize)
+	{
+		const auto end = std::min(count, begin + chunkSize);
+		group.Run([&body, begin, end]() { body(begin, end); });
+	}
+
+	//The calling thread takes the first chunk
+	body(std::size_t(0), std::min(count, chunkSize));
+
+	group.Wait();
+}
+
+#endif
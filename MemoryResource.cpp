@@ -0,0 +1,138 @@
+/*
+	Name: 			Michael Lausdahl Fuglsang
+	email:			mfugls11
+	Study No.:		20112699
+
+	Code also available at:
+	https://github.com/Malakahh/Ap-exam-part-2
+*/
+
+#include "MemoryResource.h"
+
+#include <new>
+#include <cstdint>
+#include <algorithm>
+
+/*******
+******** 	MemoryResource
+********/
+
+bool MemoryResource::IsEqual(const MemoryResource& other) const
+{
+	return this == &other;
+}
+
+/*******
+******** 	NewDeleteResource
+********/
+
+void* NewDeleteResource::Allocate(const std::size_t bytes, const std::size_t)
+{
+	return ::operator new(bytes);
+}
+
+void NewDeleteResource::Deallocate(void* p, const std::size_t, const std::size_t)
+{
+	::operator delete(p);
+}
+
+/*******
+******** 	MonotonicArena
+********/
+
+MonotonicArena::MonotonicArena(const std::size_t initialSize, MemoryResource* upstream)
+	: upstream(upstream != nullptr ? upstream : GetNewDeleteResource()), nextChunkSize(std::max<std::size_t>(initialSize, 64)),
+	current(nullptr), remaining(0), used(0) {}
+
+MonotonicArena::~MonotonicArena()
+{
+	this->Release();
+}
+
+void* MonotonicArena::Allocate(const std::size_t bytes, const std::size_t alignment)
+{
+	auto padding = (alignment - reinterpret_cast<std::uintptr_t>(this->current) % alignment) % alignment;
+
+	if (this->current == nullptr || padding + bytes > this->remaining)
+	{
+		//Chunks grow geometrically, so a batch needs few of them
+		const auto size = std::max(this->nextChunkSize, bytes + alignment);
+		auto memory = this->upstream->Allocate(size, alignof(std::max_align_t));
+
+		this->chunks.push_back({ memory, size });
+		this->nextChunkSize = 2 * size;
+
+		this->current = static_cast<char*>(memory);
+		this->remaining = size;
+		padding = (alignment - reinterpret_cast<std::uintptr_t>(this->current) % alignment) % alignment;
+	}
+
+	auto p = this->current + padding;
+	this->current += padding + bytes;
+	this->remaining -= padding + bytes;
+	this->used += bytes;
+
+	return p;
+}
+
+void MonotonicArena::Deallocate(void*, const std::size_t, const std::size_t)
+{
+	//Memory is only released all at once
+}
+
+void MonotonicArena::Release()
+{
+	for (auto& c : this->chunks)
+	{
+		this->upstream->Deallocate(c.memory, c.size, alignof(std::max_align_t));
+	}
+
+	this->chunks.clear();
+	this->current = nullptr;
+	this->remaining = 0;
+	this->used = 0;
+}
+
+std::size_t MonotonicArena::BytesUsed() const
+{
+	return this->used;
+}
+
+/*******
+******** 	Default resource
+********/
+
+namespace
+{
+	thread_local MemoryResource* defaultResource = nullptr;
+}
+
+MemoryResource* GetNewDeleteResource()
+{
+	static NewDeleteResource resource;
+	return &resource;
+}
+
+MemoryResource* GetDefaultResource()
+{
+	return defaultResource != nullptr ? defaultResource : GetNewDeleteResource();
+}
+
+void SetDefaultResource(MemoryResource* resource)
+{
+	defaultResource = resource;
+}
+
+/*******
+******** 	ResourceScope
+********/
+
+ResourceScope::ResourceScope(MemoryResource* resource) : previous(defaultResource)
+{
+	SetDefaultResource(resource);
+}
+
+ResourceScope::~ResourceScope()
+{
+	SetDefaultResource(this->previous);
+}
@@ -0,0 +1,190 @@
+/*
+	Name: 			Michael Lausdahl Fuglsang
+	email:			mfugls11
+	Study No.:		20112699
+
+	Code also available at:
+	https://github.com/Malakahh/Ap-exam-part-2
+*/
+
+#ifndef _MEMORY_RESOURCE
+#define _MEMORY_RESOURCE
+
+#include <cstddef>
+#include <vector>
+#include <memory>
+#include <type_traits>
+
+#include "PolynomialStats.h"
+
+/*
+	Source of memory for polynomial coefficients, modelled on std::pmr::memory_resource,
+	which isn't available in C++14. Implement it to plug Polynomial into an existing allocator.
+*/
+class MemoryResource
+{
+public:
+	virtual ~MemoryResource() = default;
+
+	//Allocates bytes with the given alignment, which is at most alignof(std::max_align_t).
+	virtual void* Allocate(const std::size_t bytes, const std::size_t alignment) = 0;
+
+	//Releases memory from Allocate, with the same size and alignment.
+	virtual void Deallocate(void* p, const std::size_t bytes, const std::size_t alignment) = 0;
+
+	//Whether memory from one resource can be released through the other.
+	virtual bool IsEqual(const MemoryResource& other) const;
+};
+
+/*
+	Resource using operator new and delete.
+*/
+class NewDeleteResource : public MemoryResource
+{
+public:
+	void* Allocate(const std::size_t bytes, const std::size_t alignment) override;
+	void Deallocate(void* p, const std::size_t bytes, const std::size_t alignment) override;
+};
+
+/*
+	Resource handing out memory from growing chunks and releasing it all at once, modelled on
+	std::pmr::monotonic_buffer_resource. Deallocate does nothing, so a whole batch of temporaries
+	costs a few chunk allocations and is freed by Release or the destructor.
+	It isn't thread safe, so only use it from one thread at a time.
+*/
+class MonotonicArena : public MemoryResource
+{
+private:
+	MemoryResource* upstream;
+
+	struct Chunk
+	{
+		void* memory;
+		std::size_t size;
+	};
+
+	std::vector<Chunk> chunks;
+	std::size_t nextChunkSize;
+
+	//Free space left in the current chunk
+	char* current;
+	std::size_t remaining;
+
+	//Memory handed out since the last release
+	std::size_t used;
+
+public:
+	//Creates an arena taking its chunks from upstream, starting with chunks of initialSize bytes.
+	explicit MonotonicArena(const std::size_t initialSize = 4096, MemoryResource* upstream = nullptr);
+
+	MonotonicArena(const MonotonicArena&) = delete;
+	MonotonicArena& operator=(const MonotonicArena&) = delete;
+
+	~MonotonicArena();
+
+	void* Allocate(const std::size_t bytes, const std::size_t alignment) override;
+	void Deallocate(void* p, const std::size_t bytes, const std::size_t alignment) override;
+
+	//Frees all chunks, invalidating everything allocated from the arena.
+	void Release();
+
+	//Number of bytes handed out since the arena was created or released.
+	std::size_t BytesUsed() const;
+};
+
+//Gets the resource using operator new and delete.
+MemoryResource* GetNewDeleteResource();
+
+/*
+	Gets the resource new polynomials on the calling thread take their coefficient memory from.
+	By default this is GetNewDeleteResource().
+*/
+MemoryResource* GetDefaultResource();
+
+/*
+	Sets the resource new polynomials on the calling thread take their coefficient memory from.
+	Passing nullptr restores operator new and delete.
+*/
+void SetDefaultResource(MemoryResource* resource);
+
+/*
+	Makes a resource the calling thread's default for the lifetime of the scope, e.g.
+
+		MonotonicArena arena;
+		{
+			ResourceScope scope(&arena);
+			//Temporaries created here take their memory from the arena
+		}
+
+	Polynomials created inside the scope must not outlive the resource. Copying a result
+	after the scope has ended moves it back to the default resource.
+*/
+class ResourceScope
+{
+private:
+	MemoryResource* previous;
+
+public:
+	explicit ResourceScope(MemoryResource* resource);
+
+	ResourceScope(const ResourceScope&) = delete;
+	ResourceScope& operator=(const ResourceScope&) = delete;
+
+	~ResourceScope();
+};
+
+/*
+	Allocator drawing from a MemoryResource, modelled on std::pmr::polymorphic_allocator.
+	Copies of a container take the default resource, moves and assignments keep their own.
+*/
+template <typename T> class ResourceAllocator
+{
+private:
+	MemoryResource* resource;
+
+	template <typename U> friend class ResourceAllocator;
+
+public:
+	typedef T value_type;
+	typedef std::false_type propagate_on_container_copy_assignment;
+	typedef std::false_type propagate_on_container_move_assignment;
+	typedef std::false_type propagate_on_container_swap;
+
+	ResourceAllocator() : resource(GetDefaultResource()) {}
+	ResourceAllocator(MemoryResource* resource) : resource(resource) {}
+	template <typename U> ResourceAllocator(const ResourceAllocator<U>& a) : resource(a.resource) {}
+
+	T* allocate(const std::size_t n)
+	{
+		PolynomialInstrumentation::Count(PolynomialCounter::Allocations);
+
+		return static_cast<T*>(this->resource->Allocate(n * sizeof(T), alignof(T)));
+	}
+
+	void deallocate(T* p, const std::size_t n)
+	{
+		this->resource->Deallocate(p, n * sizeof(T), alignof(T));
+	}
+
+	ResourceAllocator select_on_container_copy_construction() const
+	{
+		return ResourceAllocator();
+	}
+
+	MemoryResource* GetResource() const
+	{
+		return this->resource;
+	}
+
+	template <typename U> bool operator==(const ResourceAllocator<U>& a) const
+	{
+		return this->resource == a.resource || this->resource->IsEqual(*a.resource);
+	}
+
+	template <typename U> bool operator!=(const ResourceAllocator<U>& a) const
+	{
+		return !(*this == a);
+	}
+};
+
+#endif
@@ -0,0 +1,126 @@
+/*
+	Name: 			Michael Lausdahl Fuglsang
+	email:			mfugls11
+	Study No.:		20112699
+
+	Code also available at:
+	https://github.com/Malakahh/Ap-exam-part-2
+*/
+
+#ifndef _MOD_INT
+#define _MOD_INT
+
+#include <cstdint>
+#include <iostream>
+
+/*
+	Integer modulo the prime P, for exact polynomial arithmetic without overflow or rounding.
+	Values are kept reduced to [0, P). P must be prime for division, and below 2^31 so sums fit 32 bits.
+
+	Used as a coefficient type, Polynomial<ModInt<P>> multiplies with a number theoretic transform.
+	Moduli with a large power of two in P - 1, like 998244353, transform directly, other moduli,
+	like 1000000007, transform modulo three such primes and reconstruct the products by CRT.
+*/
+template <std::uint32_t P> class ModInt
+{
+	static_assert(P >= 2 && P < (1u << 31), "The modulus must be at least 2 and below 2^31");
+
+private:
+	std::uint32_t value;
+
+public:
+	static const std::uint32_t modulus = P;
+
+	constexpr ModInt() : value(0) {}
+
+	//Reduces any integer, negative ones included, so literals and sizes convert implicitly.
+	constexpr ModInt(const long long v) : value(static_cast<std::uint32_t>(v % static_cast<long long>(P) < 0
+		? v % static_cast<long long>(P) + P : v % static_cast<long long>(P))) {}
+
+	//Gets the representative in [0, P).
+	constexpr std::uint32_t Value() const { return this->value; }
+
+	ModInt& operator+=(const ModInt rhs)
+	{
+		this->value += rhs.value;
+		if (this->value >= P)
+		{
+			this->value -= P;
+		}
+
+		return *this;
+	}
+
+	ModInt& operator-=(const ModInt rhs)
+	{
+		this->value += P - rhs.value;
+		if (this->value >= P)
+		{
+			this->value -= P;
+		}
+
+		return *this;
+	}
+
+	//P is a compile time constant, so the reduction compiles to multiplications instead of a division
+	ModInt& operator*=(const ModInt rhs)
+	{
+		this->value = static_cast<std::uint32_t>(static_cast<std::uint64_t>(this->value) * rhs.value % P);
+
+		return *this;
+	}
+
+	//Division by 0 gives 0, as 0 has no inverse.
+	ModInt& operator/=(const ModInt rhs)
+	{
+		return *this *= rhs.Inverse();
+	}
+
+	ModInt operator-() const
+	{
+		return ModInt() -= *this;
+	}
+
+	friend ModInt operator+(ModInt lhs, const ModInt rhs) { return lhs += rhs; }
+	friend ModInt operator-(ModInt lhs, const ModInt rhs) { return lhs -= rhs; }
+	friend ModInt operator*(ModInt lhs, const ModInt rhs) { return lhs *= rhs; }
+	friend ModInt operator/(ModInt lhs, const ModInt rhs) { return lhs /= rhs; }
+
+	friend bool operator==(const ModInt lhs, const ModInt rhs) { return lhs.value == rhs.value; }
+	friend bool operator!=(const ModInt lhs, const ModInt rhs) { return lhs.value != rhs.value; }
+
+	//Orders by representative, which has no arithmetic meaning but lets ModInt be sorted and searched.
+	friend bool operator<(const ModInt lhs, const ModInt rhs) { return lhs.value < rhs.value; }
+
+	//Raises to a power by repeated squaring.
+	ModInt Pow(std::uint64_t exponent) const
+	{
+		ModInt res = 1;
+		ModInt base = *this;
+
+		for (; exponent > 0; exponent >>= 1)
+		{
+			if (exponent & 1)
+			{
+				res *= base;
+			}
+
+			base *= base;
+		}
+
+		return res;
+	}
+
+	//Multiplicative inverse by Fermat's little theorem, a^(P - 2).
+	ModInt Inverse() const
+	{
+		return this->Pow(P - 2);
+	}
+
+	friend std::ostream& operator<<(std::ostream& s, const ModInt v)
+	{
+		return s << v.value;
+	}
+};
+
+#endif
@@ -8,25 +8,330 @@
 */
 
 #include "Polynomial.h"
+#include "PolynomialKernels.h"
+#include "ModInt.h"
+
+#include <limits>
 
 /*******
 ******** 	Private Members
 ********/
 
+namespace
+{
+	//Locks a polynomial, counting the times another thread holds it already
+	std::unique_lock<std::mutex> Lock(std::mutex& guard)
+	{
+		std::unique_lock<std::mutex> lock(guard, std::try_to_lock);
+
+		if (!lock.owns_lock())
+		{
+			PolynomialInstrumentation::Count(PolynomialCounter::LockWaits);
+			lock.lock();
+		}
+
+		return lock;
+	}
+
+	//Multiplication settings currently in effect for a coefficient type
+	template <typename C> PolynomialKernels::Multiplier CurrentMultiplier()
+	{
+		auto thresholds = Polynomial<C>::GetMultiplicationThresholds();
+
+		return { thresholds.karatsuba, thresholds.fft, GetDefaultExecutor() };
+	}
+}
+
 /*
 	Pimpl idiom used for move semantics.
 	Solves requirement 7.
+
+	Stored in place in Polynomial::storage rather than on the heap.
 */
 template <typename C> struct Polynomial<C>::PolynomialData
 {
-	std::vector<C> coefficients;
+	typedef PolynomialKernels::Term<C> Term;
+
+	//Storage is only considered for sparse mode from this number of coefficients
+	static const std::size_t sparseMinimumSize = 64;
+
+	//Dense storage switches to sparse when fewer than 1 in sparseFillRatio coefficients are non-zero
+	static const std::size_t sparseFillRatio = 8;
+
+	//Sparse storage switches back to dense when at least 1 in denseFillRatio coefficients are non-zero
+	static const std::size_t denseFillRatio = 4;
+
+	//Dense storage, inline up to inlineCapacity coefficients
+	CoefficientBuffer<C, inlineCapacity> coefficients;
+
+	/*
+		Sparse storage, used in place of coefficients when few terms are non-zero.
+		Holds the non-zero terms sorted by exponent, and the number of coefficients
+		the polynomial has in dense form.
+	*/
+	bool sparse = false;
+	std::vector<Term> terms;
+	std::size_t sparseSize = 0;
 
 	/*
 		Integral cache used for requirement 6.
+		Holds the antiderivative of one version of the coefficients. It is built lazily under integralGuard
+		and published through an atomic pointer, so integrals never lock once it exists.
+		Copies start out with an empty cache.
+	*/
+	struct AntiderivativeSnapshot
+	{
+		unsigned long long version;
+		Polynomial<C> antiderivative;
+	};
+
+	struct IntegralCache
+	{
+		std::atomic<const AntiderivativeSnapshot*> snapshot;
+
+		IntegralCache() : snapshot(nullptr) {}
+		IntegralCache(const IntegralCache&) : snapshot(nullptr) {}
+		IntegralCache(IntegralCache&& c) : snapshot(c.snapshot.exchange(nullptr)) {}
+		~IntegralCache() { this->Reset(); }
+
+		IntegralCache& operator=(const IntegralCache&)
+		{
+			this->Reset();
+			return *this;
+		}
+
+		void Reset()
+		{
+			delete this->snapshot.exchange(nullptr);
+		}
+	};
+
+	//Coefficient version, bumped by every change to the polynomial
+	unsigned long long version = 0;
+	IntegralCache integralCache;
+
+	PolynomialData() = default;
+	explicit PolynomialData(MemoryResource* resource) : coefficients(resource) {}
+	PolynomialData(const PolynomialData&) = default;
+	PolynomialData& operator=(const PolynomialData&) = default;
+
+	//Moves leave the source without coefficients, and hand over the integral cache
+	PolynomialData(PolynomialData&& d) : coefficients(std::move(d.coefficients)), sparse(d.sparse), terms(std::move(d.terms)),
+		sparseSize(d.sparseSize), version(d.version), integralCache(std::move(d.integralCache))
+	{
+		d.Clear();
+	}
+
+	PolynomialData& operator=(PolynomialData&& d)
+	{
+		if (this != &d)
+		{
+			this->coefficients = std::move(d.coefficients);
+			this->sparse = d.sparse;
+			this->terms = std::move(d.terms);
+			this->sparseSize = d.sparseSize;
+			this->InvalidateCache();
+			d.Clear();
+		}
+
+		return *this;
+	}
+
+	//Removes all coefficients
+	void Clear()
+	{
+		this->coefficients.clear();
+		this->terms = std::vector<Term>();
+		this->sparse = false;
+		this->sparseSize = 0;
+		this->InvalidateCache();
+	}
+
+	//Invalidates cached data, call whenever the polynomial is altered
+	void InvalidateCache()
+	{
+		this->version++;
+		this->integralCache.Reset();
+	}
+
+	//Number of coefficients, i.e. highest exponent + 1, in either storage mode
+	std::size_t Size() const
+	{
+		return this->sparse ? this->sparseSize : this->coefficients.size();
+	}
+
+	//Switches to dense storage
+	void Densify()
+	{
+		if (this->sparse)
+		{
+			this->coefficients = PolynomialKernels::ToDense(this->terms, this->sparseSize);
+			this->terms = std::vector<Term>();
+			this->sparse = false;
+		}
+	}
+
+	//Switches to sparse storage
+	void Sparsify()
+	{
+		if (!this->sparse)
+		{
+			this->terms = PolynomialKernels::ToTerms(this->coefficients.data(), this->coefficients.size());
+			this->sparseSize = this->coefficients.size();
+			this->coefficients = std::vector<C>();
+			this->sparse = true;
+		}
+	}
+
+	/*
+		Picks the storage mode from the fill ratio.
+		This scans dense coefficients, so only use it after operations that are O(n) anyway.
 	*/
-	std::unordered_map<int, C> integralData;
+	void UpdateStorage()
+	{
+		if (this->sparse)
+		{
+			if (this->sparseSize < sparseMinimumSize || this->terms.size() * denseFillRatio >= this->sparseSize)
+			{
+				this->Densify();
+			}
+		}
+		else if (this->coefficients.size() >= sparseMinimumSize)
+		{
+			auto nonZero = std::count_if(this->coefficients.begin(), this->coefficients.end(), [](const C c) { return c != C(0); });
+
+			if (static_cast<std::size_t>(nonZero) * sparseFillRatio < this->coefficients.size())
+			{
+				this->Sparsify();
+			}
+		}
+	}
+
+	//Finds the term with the given exponent, or where it would be inserted
+	typename std::vector<Term>::iterator FindTerm(const std::size_t exponent)
+	{
+		return std::lower_bound(this->terms.begin(), this->terms.end(), exponent,
+			[](const Term& t, const std::size_t e) { return t.exponent < e; });
+	}
 };
 
+//Gets the implementation stored in place
+template <typename C> typename Polynomial<C>::PolynomialData& Polynomial<C>::Impl() const
+{
+	static_assert(sizeof(PolynomialData) <= sizeof(storage) && alignof(PolynomialData) <= alignof(decltype(storage)),
+		"PolynomialData must fit in Polynomial::storage");
+
+	return *reinterpret_cast<PolynomialData*>(&this->storage);
+}
+
+/*
+	Multiplication algorithm thresholds, tunable at runtime per coefficient type.
+*/
+template <typename C> std::atomic<std::size_t> Polynomial<C>::karatsubaThreshold(64);
+template <typename C> std::atomic<std::size_t> Polynomial<C>::fftThreshold(256);
+
+/*
+	Batched evaluation threshold for remainder trees, tunable at runtime per coefficient type.
+	The subproduct tree of many points overflows and loses precision in floating point,
+	so for those types remainder trees are only used when the threshold is set explicitly.
+*/
+template <typename C> std::atomic<std::size_t> Polynomial<C>::multipointThreshold(
+	std::is_floating_point<C>::value ? std::numeric_limits<std::size_t>::max() : 32768);
+
+/*
+	Gets the antiderivative of the current coefficients, with a zero constant term.
+	Readers only do an atomic load once the cache holds the current version. On a miss
+	the antiderivative is built under integralGuard and published for the following readers.
+*/
+template <typename C> const Polynomial<C>& Polynomial<C>::GetAntiderivative() const
+{
+	auto& data = this->Impl();
+	auto snapshot = data.integralCache.snapshot.load(std::memory_order_acquire);
+
+	if (snapshot == nullptr || snapshot->version != data.version)
+	{
+		auto lock = Lock(this->integralGuard);
+
+		//Another reader may have built it while we waited for the lock
+		snapshot = data.integralCache.snapshot.load(std::memory_order_acquire);
+
+		if (snapshot == nullptr || snapshot->version != data.version)
+		{
+			PolynomialInstrumentation::Count(PolynomialCounter::IntegralCacheMisses);
+
+			//The cache lives as long as the polynomial, so it takes memory from the same resource
+			Polynomial<C> antiderivative(data.coefficients.GetResource());
+			auto& target = antiderivative.Impl();
+
+			if (data.sparse)
+			{
+				target.coefficients = std::vector<C>();
+				target.terms = PolynomialKernels::IntegrateSparse(data.terms);
+				target.sparseSize = data.sparseSize + 1;
+				target.sparse = true;
+			}
+			else
+			{
+				target.coefficients.resize(data.coefficients.size() + 1);
+				PolynomialKernels::Integrate(data.coefficients.data(), data.coefficients.size(), target.coefficients.data());
+			}
+
+			auto fresh = new typename PolynomialData::AntiderivativeSnapshot{ data.version, std::move(antiderivative) };
+			delete data.integralCache.snapshot.exchange(fresh, std::memory_order_acq_rel);
+
+			snapshot = fresh;
+		}
+		else
+		{
+			PolynomialInstrumentation::Count(PolynomialCounter::IntegralCacheHits);
+		}
+	}
+	else
+	{
+		PolynomialInstrumentation::Count(PolynomialCounter::IntegralCacheHits);
+	}
+
+	return snapshot->antiderivative;
+}
+
+/*
+	Multiplies the polynomial with the linear factors (x - root) of all the given roots.
+	The factors are combined in a product tree first, see PolynomialKernels::RootProduct.
+*/
+template <typename C> void Polynomial<C>::AddRoots(const std::vector<C>& roots)
+{
+	Polynomial<C> factors;
+	factors.Impl().coefficients = PolynomialKernels::RootProduct(roots.data(), roots.size(), CurrentMultiplier<C>());
+
+	*this *= factors;
+}
+
+/*******
+******** 	Mutation
+********/
+
+//Starts a mutation, locking the polynomial and expanding it to dense storage
+template <typename C> Polynomial<C>::Mutation::Mutation(Polynomial<C>& p) : polynomial(&p), lock(Lock(p.integralGuard))
+{
+	p.Impl().Densify();
+	this->coefficients = &p.Impl().coefficients;
+}
+
+template <typename C> Polynomial<C>::Mutation::Mutation(Mutation&& m) : polynomial(m.polynomial), lock(std::move(m.lock)), coefficients(m.coefficients)
+{
+	m.polynomial = nullptr;
+}
+
+//Ends the mutation, picking the storage mode and invalidating the caches once
+template <typename C> Polynomial<C>::Mutation::~Mutation()
+{
+	if (this->polynomial != nullptr)
+	{
+		this->polynomial->Impl().UpdateStorage();
+		this->polynomial->Impl().InvalidateCache();
+	}
+}
+
 /*******
 ******** 	Constructors/Destructor
 ********/
@@ -37,327 +342,1134 @@ template <typename C> struct Polynomial<C>::PolynomialData
 */
 template <typename C> Polynomial<C>::Polynomial(): Polynomial(0,0) {}
 
-//Copy constructor
-template <typename C> Polynomial<C>::Polynomial(const Polynomial<C>& p) : pImpl(std::make_unique<Polynomial<C>::PolynomialData>(*p.pImpl)) {}
+//Creates a trivial Polynomial taking its coefficient memory from the given resource
+template <typename C> Polynomial<C>::Polynomial(MemoryResource* resource)
+{
+	new (&this->storage) PolynomialData(resource);
+	this->SetCoefficient(0, 0);
+}
+
+//Copy constructor
+template <typename C> Polynomial<C>::Polynomial(const Polynomial<C>& p)
+{
+	new (&this->storage) PolynomialData(p.Impl());
+}
+
+//Move constructor, leaves p without coefficients
+template <typename C> Polynomial<C>::Polynomial(Polynomial<C>&& p)
+{
+	new (&this->storage) PolynomialData(std::move(p.Impl()));
+}
+
+/*
+	Braced initialization
+	You use this for creating a polynomial with specific degree coefficients. Solves requirement 1b,
+		as well as the braced initializer support from requirement 5.
+*/
+template <typename C> Polynomial<C>::Polynomial(std::initializer_list<C> list)
+{
+	new (&this->storage) PolynomialData();
+	this->SetCoefficientRange<std::initializer_list<C>>(list.begin(), list.end());
+}
+
+//Insert data, form: value * x^exponent
+template <typename C> Polynomial<C>::Polynomial(const C value, const unsigned int exponent)
+{
+	new (&this->storage) PolynomialData();
+	this->SetCoefficient(value, exponent);
+}
+
+template <typename C> Polynomial<C>::~Polynomial()
+{
+	this->Impl().~PolynomialData();
+}
+
+/*******
+******** 	Public Members
+********/
+
+//Sets a coefficient of the form: value * x^exponent
+template <typename C> void Polynomial<C>::SetCoefficient(const C value, const unsigned int exponent)
+{
+	//Make sure to clear cache before we alter the polynomial
+	auto lock = Lock(this->integralGuard);
+	this->Impl().InvalidateCache();
+
+	auto& data = this->Impl();
+
+	//Jumping far past the current degree would mostly store zeros, so switch to sparse storage
+	if (!data.sparse && exponent >= data.coefficients.size() && exponent + 1 >= PolynomialData::sparseMinimumSize
+		&& exponent + 1 > PolynomialData::sparseFillRatio * data.coefficients.size())
+	{
+		data.Sparsify();
+	}
+
+	if (data.sparse)
+	{
+		auto term = data.FindTerm(exponent);
+
+		if (term != data.terms.end() && term->exponent == exponent)
+		{
+			if (value != C(0))
+			{
+				term->value = value;
+			}
+			else
+			{
+				data.terms.erase(term);
+			}
+		}
+		else if (value != C(0))
+		{
+			data.terms.insert(term, { exponent, value });
+		}
+
+		data.sparseSize = std::max<std::size_t>(data.sparseSize, exponent + 1);
+
+		if (data.terms.size() * PolynomialData::denseFillRatio >= data.sparseSize)
+		{
+			data.Densify();
+		}
+	}
+	else if (exponent < this->Impl().coefficients.size()) //Alter value currently stored
+	{
+		this->Impl().coefficients[exponent] = value;
+	}
+	else //exponent is higher than the currently highest
+	{
+		//Set new highest exponent, filling any in between with 0 values
+		for (auto i = this->Impl().coefficients.size(); i < exponent + 1; i++)
+		{
+			if (i < exponent)
+			{
+				this->Impl().coefficients.push_back(0);
+			}
+			else
+			{
+				this->Impl().coefficients.push_back(value);
+			}
+		}
+	}
+}
+
+//Starts a batch of changes, see Mutation.
+template <typename C> typename Polynomial<C>::Mutation Polynomial<C>::Mutate()
+{
+	return Mutation(*this);
+}
+
+//Gets a coefficient for a specific exponent.
+template <typename C> C Polynomial<C>::GetCoefficient(const unsigned int exponent) const
+{
+	//Throw error if requested exponent is higher than what currently exists in this polynomial.
+	if (exponent >= this->Impl().Size())
+	{
+		throw std::out_of_range("Index out of bounds");
+	}
+
+	if (this->Impl().sparse)
+	{
+		auto term = this->Impl().FindTerm(exponent);
+
+		return term != this->Impl().terms.end() && term->exponent == exponent ? term->value : C(0);
+	}
+
+	return this->Impl().coefficients[exponent];
+}
+
+//Gets the coefficient for the highest exponent.
+template <typename C> C Polynomial<C>::GetHighestCoefficient() const
+{
+	return this->Impl().Size() - 1;
+}
+
+//Gets the number of coefficients, i.e. highest exponent + 1.
+template <typename C> std::size_t Polynomial<C>::Size() const
+{
+	return this->Impl().Size();
+}
+
+//Gets the resource the coefficients take their memory from.
+template <typename C> MemoryResource* Polynomial<C>::GetResource() const
+{
+	return this->Impl().coefficients.GetResource();
+}
+
+//Contiguous coefficient buffer, or nullptr when the polynomial is stored sparse.
+template <typename C> const C* Polynomial<C>::Data() const
+{
+	return this->Impl().sparse ? nullptr : this->Impl().coefficients.data();
+}
+
+/*
+	Scales the polynomial by the given value.
+	Solves requirement 1c.
+*/
+template <typename C> void Polynomial<C>::Scale(const C scalar)
+{
+	if (this->Impl().sparse)
+	{
+		auto lock = Lock(this->integralGuard);
+		this->Impl().InvalidateCache();
+
+		for (auto& t : this->Impl().terms)
+		{
+			t.value *= scalar;
+		}
+
+		if (scalar == C(0))
+		{
+			this->Impl().terms.clear();
+		}
+
+		return;
+	}
+
+	Mutation m(*this);
+
+	//Calculate scale for each term
+	for (std::size_t i = 0; i < m.Size(); i++)
+	{
+		m[i] *= scalar;
+	}
+}
+
+//Scales the polynomial, splitting the coefficients across the executor of the policy.
+template <typename C> void Polynomial<C>::Scale(const ExecutionPolicy& policy, const C scalar)
+{
+	if (this->Impl().sparse)
+	{
+		this->Scale(scalar);
+		return;
+	}
+
+	Mutation m(*this);
+	auto coefficients = m.Data();
+
+	ParallelFor(GetPolicyExecutor(policy), m.Size(), PolynomialKernels::parallelWorkThreshold, [&](const std::size_t begin, const std::size_t end) {
+		for (auto i = begin; i < end; i++)
+		{
+			coefficients[i] *= scalar;
+		}
+	});
+}
+
+/*
+	Adds a root to the polynomial (by multiplying with x - root).
+	Solves requirement 1d.
+*/
+template <typename C> void Polynomial<C>::AddRoot(const C root)
+{
+	//Sparse polynomials multiply their terms directly
+	if (this->Impl().sparse)
+	{
+		*this *= Polynomial<C>{ -root, 1 };
+		return;
+	}
+
+	Mutation m(*this);
+
+	const auto size = m.Size();
+	m.Resize(size + 1);
+
+	//Move each value to the higher exponent, and subtract root times the current one
+	for (auto i = size; i > 0; i--)
+	{
+		m[i] = m[i - 1] - root * m[i];
+	}
+
+	m[0] = -root * m[0];
+}
+
+/*
+	Taylor shift, p(x + a). Below twice the Karatsuba threshold the divide and conquer
+	composition has no faster multiplication to build on, so the shift is done in place.
+*/
+template <typename C> void Polynomial<C>::Shift(const C a)
+{
+	Mutation m(*this);
+
+	const auto size = m.Size();
+	auto multiply = CurrentMultiplier<C>();
+
+	if (size < 2 * multiply.karatsubaThreshold)
+	{
+		PolynomialKernels::ShiftInPlace(m.Data(), size, a);
+		return;
+	}
+
+	auto shifted = PolynomialKernels::Compose(m.Data(), size, std::vector<C>{ a, C(1) }, multiply);
+	std::copy(shifted.begin(), shifted.begin() + size, m.Data());
+}
+
+//Affine change of variable, p(s * x + t).
+template <typename C> void Polynomial<C>::Affine(const C s, const C t)
+{
+	this->Shift(t);
+
+	Mutation m(*this);
+
+	C power = 1;
+	for (std::size_t i = 0; i < m.Size(); i++)
+	{
+		m[i] *= power;
+		power *= s;
+	}
+}
+
+//Composition, p(q(x)).
+template <typename C> void Polynomial<C>::Compose(const Polynomial<C>& q)
+{
+	auto inner = std::vector<C>(q.Size());
+	auto data = q.Data();
+	for (std::size_t i = 0; i < inner.size(); i++)
+	{
+		inner[i] = data != nullptr ? data[i] : q.GetCoefficient(static_cast<unsigned int>(i));
+	}
+
+	Mutation m(*this);
+
+	if (m.Size() == 0 || inner.empty())
+	{
+		return;
+	}
+
+	auto composed = PolynomialKernels::Compose(m.Data(), m.Size(), inner, CurrentMultiplier<C>());
+
+	m.Resize(composed.size());
+	std::copy(composed.begin(), composed.end(), m.Data());
+}
+
+/*
+	Valuates the polynomial at a given point.
+	Solves requirement 1f.
+*/
+template <typename C> C Polynomial<C>::ValueAt(const C x) const
+{
+	PolynomialInstrumentation::Count(PolynomialCounter::Evaluations);
+
+	if (this->Impl().sparse)
+	{
+		return PolynomialKernels::EvaluateSparse(this->Impl().terms, x);
+	}
+
+	auto& coefficients = this->Impl().coefficients;
+
+	return PolynomialKernels::Evaluate(coefficients.data(), coefficients.size(), x);
+}
+
+/*
+	Valuates the polynomial at every point in [first, last), writing the results to out.
+*/
+template <typename C> void Polynomial<C>::ValueAtRange(const C* first, const C* last, C* out) const
+{
+	PolynomialInstrumentation::Count(PolynomialCounter::BatchEvaluations);
+	PolynomialInstrumentation::Count(PolynomialCounter::EvaluatedPoints, last - first);
+
+	if (this->Impl().sparse)
+	{
+		for (; first != last; first++, out++)
+		{
+			*out = PolynomialKernels::EvaluateSparse(this->Impl().terms, *first);
+		}
+
+		return;
+	}
+
+	auto& coefficients = this->Impl().coefficients;
+	auto count = coefficients.size();
+	auto n = static_cast<std::size_t>(last - first);
+
+	//Many points on a high degree polynomial, use a remainder tree
+	auto threshold = multipointThreshold.load(std::memory_order_relaxed);
+	if (n >= threshold && count >= threshold)
+	{
+		PolynomialInstrumentation::Count(PolynomialCounter::MultipointEvaluations);
+		PolynomialKernels::EvaluateMultipoint(coefficients.data(), count, first, out, n, CurrentMultiplier<C>());
+		return;
+	}
+
+	//Split the points across the executor when there is enough work
+	auto grain = std::max<std::size_t>(64, PolynomialKernels::parallelWorkThreshold / std::max<std::size_t>(count, 1));
+
+	ParallelFor(GetDefaultExecutor(), n, grain, [&](const std::size_t begin, const std::size_t end) {
+		PolynomialKernels::EvaluateBatch(coefficients.data(), count, first + begin, out + begin, end - begin);
+	});
+}
+
+/*
+	Computes a polynomial which is a derivative of this polynomial.
+	Solves requirement 1g.
+*/
+template <typename C> Polynomial<C> Polynomial<C>::CalculateDerivative() const
+{
+	//Prepare derivative polynomial by copying current one
+	Polynomial p(*this);
+
+	if (p.Impl().sparse)
+	{
+		p.Impl().InvalidateCache();
+		p.Impl().terms = PolynomialKernels::DerivativeSparse(p.Impl().terms);
+		p.Impl().sparseSize--;
+		p.Impl().UpdateStorage();
+
+		return p;
+	}
+
+	{
+		Mutation m(p);
+
+		//Calculate derivative polynomial
+		for (std::size_t i = 1; i < m.Size(); i++)
+		{
+			m[i - 1] = m[i] * static_cast<C>(i);
+		}
+
+		//Erase highest exponent, as it is now invalidated
+		if (m.Size() > 0)
+		{
+			m.Resize(m.Size() - 1);
+		}
+	}
+
+	return p;
+}
+
+/*
+	Computes the derivative, splitting the coefficients across the executor of the policy.
+	Writing the derivative in place would let neighbouring ranges overwrite each other's input, so it is built in a new buffer.
+*/
+template <typename C> Polynomial<C> Polynomial<C>::CalculateDerivative(const ExecutionPolicy& policy) const
+{
+	const auto size = this->Size();
+
+	if (this->Impl().sparse || size < 2)
+	{
+		return this->CalculateDerivative();
+	}
+
+	Polynomial<C> p(this->GetResource());
+
+	{
+		Mutation m(p);
+		m.Resize(size - 1);
+
+		auto source = this->Data();
+		auto target = m.Data();
+
+		ParallelFor(GetPolicyExecutor(policy), size - 1, PolynomialKernels::parallelWorkThreshold, [&](const std::size_t begin, const std::size_t end) {
+			for (auto i = begin; i < end; i++)
+			{
+				target[i] = source[i + 1] * static_cast<C>(i + 1);
+			}
+		});
+	}
+
+	return p;
+}
+
+/*
+	Integral tag dispatch, used for requirement 8.
+*/
+template <typename C> C Polynomial<C>::CalculateIntegralDispatch(const C, const C, std::true_type) const
+{
+	/*
+		Integrals aren't defined for int types, like the batched integrals.
+		Used for requirement 8.
+	*/
+	throw std::domain_error("Integrals for integer types are not supported");
+}
+
+/*
+	Integral tag dispatch, used for requirement 8.
+*/
+template <typename C> C Polynomial<C>::CalculateIntegralDispatch(const C a, const C b, std::false_type) const
+{
+	//Antiderivative of the current coefficients, from the cache
+	auto antiderivative = &this->GetAntiderivative();
+
+	/*
+		Lambda expression used to calculate one part of an integral.
+		Solves requirement 9.
+
+		In addition, I'm using auto here to deduce types.
+		This solves requirement 3.
+
+		Each part is a single evaluation of the cached antiderivative.
+		Solves requirement 6.
+	*/
+	auto IntegralPart = [antiderivative](const auto n){
+		return antiderivative->ValueAt(n);
+	};
+
+	//Small polynomials are evaluated inline, as handing them to another thread costs more than the evaluation
+	if (antiderivative->Impl().Size() < PolynomialKernels::parallelWorkThreshold)
+	{
+		return IntegralPart(b) - IntegralPart(a);
+	}
+
+	/*
+		Run the integral part lambda concurrently on the executor.
+		Solves requirement 10.
+	*/
+	C partB = 0;
+	TaskGroup group(GetDefaultExecutor());
+	group.Run([&]() { partB = IntegralPart(b); });
+
+	auto partA = IntegralPart(a);
+
+	//Get result from task
+	group.Wait();
+	return partB - partA;
+}
+
+/*
+	Antiderivative tag dispatch for the batched integrals.
+*/
+template <typename C> void Polynomial<C>::AntiderivativeRangeDispatch(const C*, const C*, C*, std::true_type) const
+{
+	throw std::domain_error("Integrals for integer types are not supported");
+}
+
+/*
+	Antiderivative tag dispatch for the batched integrals.
+*/
+template <typename C> void Polynomial<C>::AntiderivativeRangeDispatch(const C* first, const C* last, C* out, std::false_type) const
+{
+	this->GetAntiderivative().ValueAtRange(first, last, out);
+}
+
+/*
+	Computes the integrals over the intervals [a[i], b[i]] for the bounds a in [aFirst, aLast) and the matching b from bFirst.
+*/
+template <typename C> void Polynomial<C>::CalculateIntegralRange(const C* aFirst, const C* aLast, const C* bFirst, C* out) const
+{
+	const auto count = static_cast<std::size_t>(aLast - aFirst);
+
+	//Collect the distinct bounds, as intervals often share them
+	auto bounds = std::vector<C>(aFirst, aLast);
+	bounds.insert(bounds.end(), bFirst, bFirst + count);
+	std::sort(bounds.begin(), bounds.end());
+	bounds.erase(std::unique(bounds.begin(), bounds.end()), bounds.end());
+
+	auto values = std::vector<C>(bounds.size());
+
+	typename std::is_integral<C>::type isIntegral;
+	this->AntiderivativeRangeDispatch(bounds.data(), bounds.data() + bounds.size(), values.data(), isIntegral);
+
+	//Look up the antiderivative at each bound
+	auto ValueAtBound = [&bounds, &values](const C bound) {
+		return values[std::lower_bound(bounds.begin(), bounds.end(), bound) - bounds.begin()];
+	};
+
+	for (std::size_t i = 0; i < count; i++)
+	{
+		out[i] = ValueAtBound(bFirst[i]) - ValueAtBound(aFirst[i]);
+	}
+}
+
+/*
+	Computes the integral over each bin between consecutive breakpoints in [first, last).
+*/
+template <typename C> void Polynomial<C>::CalculateIntegralBins(const C* first, const C* last, C* out) const
+{
+	const auto count = static_cast<std::size_t>(last - first);
+
+	if (count < 2)
+	{
+		return;
+	}
+
+	auto values = std::vector<C>(count);
+
+	typename std::is_integral<C>::type isIntegral;
+	this->AntiderivativeRangeDispatch(first, last, values.data(), isIntegral);
+
+	for (std::size_t i = 0; i + 1 < count; i++)
+	{
+		out[i] = values[i + 1] - values[i];
+	}
+}
+
+/*
+	Computes an integral for the given interval bounds.
+	Solves requirement 1h.
+*/
+template <typename C> C Polynomial<C>::CalculateIntegral(const C a, const C b) const
+{
+	/*
+		Integral tag dispatch using traits.
+		Solves requirement 8.
+	*/
+	typename std::is_integral<C>::type isIntergral;
+	return this->CalculateIntegralDispatch(a, b, isIntergral);
+}
+
+/*
+	Finds all complex roots by Aberth-Ehrlich iteration, see PolynomialKernels::FindRootsAberth.
+*/
+template <typename C> RootFindingResult<typename Polynomial<C>::RootScalar> Polynomial<C>::FindRoots(const RootFindingOptions& options) const
+{
+	typename std::is_arithmetic<C>::type isArithmetic;
+	return this->FindRootsDispatch(options, isArithmetic);
+}
+
+template <typename C> RootFindingResult<typename Polynomial<C>::RootScalar> Polynomial<C>::FindRootsDispatch(const RootFindingOptions&, std::false_type) const
+{
+	throw std::domain_error("Root finding needs real or integer coefficients");
+}
+
+template <typename C> template <typename D> RootFindingResult<typename Polynomial<C>::RootScalar> Polynomial<C>::FindRootsDispatch(const RootFindingOptions& options, std::true_type) const
+{
+	typedef RootScalar R;
+
+	auto coefficients = std::vector<R>(this->Size());
+	auto data = this->Data();
+	for (std::size_t i = 0; i < coefficients.size(); i++)
+	{
+		coefficients[i] = static_cast<R>(data != nullptr ? data[i] : this->GetCoefficient(static_cast<unsigned int>(i)));
+	}
+
+	while (!coefficients.empty() && coefficients.back() == R(0))
+	{
+		coefficients.pop_back();
+	}
+
+	RootFindingResult<R> result;
+	result.iterations = 0;
+	result.converged = true;
+
+	if (coefficients.size() < 2)
+	{
+		return result;
+	}
+
+	//Roots at 0 are exact, and would otherwise be slow multiple roots
+	std::size_t zeros = 0;
+	while (coefficients[zeros] == R(0))
+	{
+		zeros++;
+	}
+
+	coefficients.erase(coefficients.begin(), coefficients.begin() + zeros);
+	result.roots.assign(zeros, std::complex<R>(0));
+
+	const auto n = coefficients.size() - 1;
+	if (n == 0)
+	{
+		return result;
+	}
+
+	result.roots.resize(zeros + n);
+
+	if (n == 1)
+	{
+		result.roots[zeros] = -coefficients[0] / coefficients[1];
+		return result;
+	}
+
+	const auto tolerance = options.tolerance > 0 ? static_cast<R>(options.tolerance) : 8 * std::numeric_limits<R>::epsilon();
+	result.iterations = PolynomialKernels::FindRootsAberth(coefficients.data(), coefficients.size(), result.roots.data() + zeros,
+		tolerance, options.maxIterations, result.converged, GetDefaultExecutor());
+
+	return result;
+}
+
+/*******
+******** 	Operator overloads
+********/
+
+//Calculates the sum of this and a given polynomial
+template <typename C> Polynomial<C>& Polynomial<C>::operator+=(const Polynomial<C>& rhs)
+{
+	auto& data = this->Impl();
+	auto& rhsData = rhs.Impl();
+
+	if (data.sparse || rhsData.sparse)
+	{
+		auto lock = Lock(this->integralGuard);
+		data.InvalidateCache();
+
+		const auto size = std::max(data.Size(), rhsData.Size());
+
+		//Adding a long sparse polynomial to a short dense one would mostly store zeros
+		if (!data.sparse && size > PolynomialData::sparseFillRatio * data.coefficients.size())
+		{
+			data.Sparsify();
+		}
+
+		if (data.sparse)
+		{
+			data.terms = PolynomialKernels::AddSparse(data.terms, rhsData.sparse ? rhsData.terms
+				: PolynomialKernels::ToTerms(rhsData.coefficients.data(), rhsData.coefficients.size()));
+			data.sparseSize = size;
+		}
+		else
+		{
+			data.coefficients.resize(size, C(0));
+
+			for (auto& t : rhsData.terms)
+			{
+				data.coefficients[t.exponent] += t.value;
+			}
+		}
+
+		data.UpdateStorage();
+
+		return *this;
+	}
+
+	Mutation m(*this);
 
-//Move constructor
-template <typename C> Polynomial<C>::Polynomial(Polynomial<C>&& p) : pImpl(std::make_unique<Polynomial<C>::PolynomialData>())
-{
-	std::swap(this->pImpl, p.pImpl);
+	//Adding to itself reads the buffer being written, which is fine as each coefficient is read before it is written
+	auto& rhsCoefficients = rhsData.coefficients;
+	if (rhsCoefficients.size() > m.Size())
+	{
+		m.Resize(rhsCoefficients.size());
+	}
+
+	for (std::size_t i = 0; i < rhsCoefficients.size(); i++)
+	{
+		m[i] += rhsCoefficients[i];
+	}
+
+	return *this;
 }
 
-/*
-	Braced initialization
-	You use this for creating a polynomial with specific degree coefficients. Solves requirement 1b,
-		as well as the braced initializer support from requirement 5.
-*/
-template <typename C> Polynomial<C>::Polynomial(std::initializer_list<C> list) : pImpl(std::make_unique<Polynomial<C>::PolynomialData>())
+//Calculates the product of this and a given polynomial
+template <typename C> Polynomial<C>& Polynomial<C>::operator *=(const Polynomial<C>& rhs)
 {
-	this->SetCoefficientRange<std::initializer_list<C>>(list.begin(), list.end());
+	this->AssignProduct(*this, rhs, GetDefaultExecutor());
+
+	return *this;
 }
 
-//Insert data, form: value * x^exponent
-template <typename C> Polynomial<C>::Polynomial(const C value, const unsigned int exponent) : pImpl(std::make_unique<Polynomial<C>::PolynomialData>())
+//Adds a given polynomial, splitting the coefficients across the executor of the policy.
+template <typename C> Polynomial<C>& Polynomial<C>::Add(const ExecutionPolicy& policy, const Polynomial<C>& rhs)
 {
-	this->SetCoefficient(value, exponent);
+	if (this->Impl().sparse || rhs.Impl().sparse)
+	{
+		return *this += rhs;
+	}
+
+	Mutation m(*this);
+
+	if (rhs.Size() > m.Size())
+	{
+		m.Resize(rhs.Size());
+	}
+
+	//Adding to itself is fine, as each coefficient is read by the task writing it
+	auto coefficients = m.Data();
+	auto rhsCoefficients = rhs.Data();
+
+	ParallelFor(GetPolicyExecutor(policy), rhs.Size(), PolynomialKernels::parallelWorkThreshold, [&](const std::size_t begin, const std::size_t end) {
+		for (auto i = begin; i < end; i++)
+		{
+			coefficients[i] += rhsCoefficients[i];
+		}
+	});
+
+	return *this;
 }
 
-template <typename C> Polynomial<C>::~Polynomial() = default;
+//Multiplies by a given polynomial on the executor of the policy.
+template <typename C> Polynomial<C>& Polynomial<C>::Multiply(const ExecutionPolicy& policy, const Polynomial<C>& rhs)
+{
+	this->AssignProduct(*this, rhs, GetPolicyExecutor(policy));
 
-/*******
-******** 	Public Members
-********/
+	return *this;
+}
 
-//Sets a coefficient of the form: value * x^exponent
-template <typename C> void Polynomial<C>::SetCoefficient(const C value, const unsigned int exponent)
+//Sets this polynomial to the product of lhs and rhs, either of which may be this polynomial.
+template <typename C> void Polynomial<C>::AssignProduct(const Polynomial<C>& lhs, const Polynomial<C>& rhs, Executor& executor)
 {
 	//Make sure to clear cache before we alter the polynomial
-	std::lock_guard<std::mutex> lock(this->integralGuard);
-	this->pImpl->integralData.clear();
-
-	if (exponent < this->pImpl->coefficients.size()) //Alter value currently stored
-	{
-		this->pImpl->coefficients[exponent] = value;
-	}
-	else //exponent is higher than the currently highest
+	auto lock = Lock(this->integralGuard);
+	this->Impl().InvalidateCache();
+
+	auto& data = this->Impl();
+	auto& lhsData = lhs.Impl();
+	auto& rhsData = rhs.Impl();
+	auto n = lhsData.Size();
+	auto m = rhsData.Size();
+	auto size = n > 0 && m > 0 ? n + m - 1 : 0;
+
+	const C* lhsCoefficients = lhsData.coefficients.data();
+	const C* rhsCoefficients = rhsData.coefficients.data();
+	std::vector<C> lhsDense;
+	std::vector<C> rhsDense;
+
+	if (lhsData.sparse || rhsData.sparse)
 	{
-		//Set new highest exponent, filling any in between with 0 values
-		for (auto i = this->pImpl->coefficients.size(); i < exponent + 1; i++)
+		auto lhsTerms = lhsData.sparse ? lhsData.terms : PolynomialKernels::ToTerms(lhsCoefficients, n);
+		auto rhsTerms = rhsData.sparse ? rhsData.terms : PolynomialKernels::ToTerms(rhsCoefficients, m);
+
+		/*
+			Multiply term by term while the pairwise products are fewer than the coefficients of a dense product.
+			Signed integer products that may overflow go through the dense product, which checks for it.
+		*/
+		std::integral_constant<bool, std::is_integral<C>::value && std::is_signed<C>::value> isSignedIntegral;
+		if (lhsTerms.size() * rhsTerms.size() <= size && !PolynomialKernels::SparseProductMayOverflow(lhsTerms, rhsTerms, isSignedIntegral))
 		{
-			if (i < exponent)
-			{
-				this->pImpl->coefficients.push_back(0);
-			}
-			else
-			{
-				this->pImpl->coefficients.push_back(value);
-			}
+			PolynomialInstrumentation::Count(PolynomialCounter::SparseMultiplications);
+			data.terms = PolynomialKernels::MultiplySparse(lhsTerms, rhsTerms);
+			data.sparseSize = size;
+			data.coefficients = std::vector<C>();
+			data.sparse = true;
+			data.UpdateStorage();
+
+			return;
+		}
+
+		//Otherwise expand sparse operands and multiply densely
+		if (lhsData.sparse)
+		{
+			lhsDense = PolynomialKernels::ToDense(lhsData.terms, n);
+			lhsCoefficients = lhsDense.data();
+		}
+
+		if (rhsData.sparse)
+		{
+			rhsDense = PolynomialKernels::ToDense(rhsData.terms, m);
+			rhsCoefficients = rhsDense.data();
 		}
 	}
+
+	//Prepare new list, from the same resource so it can be handed over
+	CoefficientBuffer<C, inlineCapacity> res(data.coefficients.GetResource());
+	res.resize(size);
+
+	//Calculate product, picking the algorithm by operand size, with integer overflow reported
+	PolynomialKernels::Multiply(lhsCoefficients, n, rhsCoefficients, m, res.data(),
+		karatsubaThreshold.load(std::memory_order_relaxed), fftThreshold.load(std::memory_order_relaxed), executor, true);
+
+	data.coefficients = std::move(res);
+	data.terms = std::vector<PolynomialKernels::Term<C>>();
+	data.sparse = false;
+	data.UpdateStorage();
 }
 
-//Gets a coefficient for a specific exponent.
-template <typename C> C Polynomial<C>::GetCoefficient(const unsigned int exponent) const
+//Divides by a given polynomial, keeping the quotient.
+template <typename C> Polynomial<C>& Polynomial<C>::operator/=(const Polynomial<C>& rhs)
 {
-	//Throw error if requested exponent is higher than what currently exists in this polynomial.
-	if (exponent >= this->pImpl->coefficients.size())
-	{
-		throw std::out_of_range("Index out of bounds");
-	}
+	this->DivideInPlace(rhs, this);
 
-	return this->pImpl->coefficients[exponent];
+	return *this;
 }
 
-//Gets the coefficient for the highest exponent.
-template <typename C> C Polynomial<C>::GetHighestCoefficient() const
+//Divides by a given polynomial, keeping the remainder.
+template <typename C> Polynomial<C>& Polynomial<C>::operator%=(const Polynomial<C>& rhs)
 {
-	return this->pImpl->coefficients.size() - 1;
+	this->DivideInPlace(rhs, nullptr);
+
+	return *this;
 }
 
 /*
-	Scales the polynomial by the given value.
-	Solves requirement 1c.
+	Divides this polynomial by divisor in place. The division leaves the remainder in the low
+	coefficients of the buffer and the quotient above them, then one of them is kept.
 */
-template <typename C> void Polynomial<C>::Scale(const C scalar)
+template <typename C> void Polynomial<C>::DivideInPlace(const Polynomial<C>& divisor, Polynomial<C>* quotient)
 {
-	//Calculate scale for each term
-	for (auto i = 0; i <= this->GetHighestCoefficient(); i++)
+	//Dense divisor coefficients, copied if the divisor is sparse or is this polynomial
+	auto b = divisor.Data();
+	auto m = divisor.Size();
+	std::vector<C> divisorCopy;
+
+	if (b == nullptr || &divisor == this)
+	{
+		divisorCopy.resize(m);
+		for (std::size_t i = 0; i < m; i++)
+		{
+			divisorCopy[i] = divisor.GetCoefficient(static_cast<unsigned int>(i));
+		}
+
+		b = divisorCopy.data();
+	}
+
+	//Leading zeros don't count towards the degree
+	while (m > 0 && b[m - 1] == C(0))
 	{
-		this->SetCoefficient(this->GetCoefficient(i) * scalar, i);
+		m--;
 	}
-}
 
-/*
-	Adds a root to the polynomial (by multiplying with x - root).
-	Solves requirement 1d.
-*/
-template <typename C> void Polynomial<C>::AddRoot(const C root)
-{
-	for (auto i = this->GetHighestCoefficient(); i >= 0; i--)
+	if (m == 0)
+	{
+		throw std::domain_error("Division by the zero polynomial");
+	}
+
+	Mutation mutation(*this);
+	auto r = mutation.Data();
+	auto n = mutation.Size();
+
+	while (n > 0 && r[n - 1] == C(0))
+	{
+		n--;
+	}
+
+	std::size_t quotientSize = 0;
+	std::size_t remainderSize = n;
+
+	if (n >= m)
 	{
-		//Move value to higher exponent
-		if (i == this->GetHighestCoefficient())
+		quotientSize = n - m + 1;
+		remainderSize = m - 1;
+
+		//Newton division needs an exact reciprocal of the leading coefficient, which integers only have for 1 and -1
+		auto multiply = CurrentMultiplier<C>();
+		auto exactInverse = !std::is_integral<C>::value || b[m - 1] == C(1) || b[m - 1] == C(-1);
+
+		if (std::min(quotientSize, m) >= 2 * multiply.karatsubaThreshold && exactInverse)
 		{
-			//Higher exponent does not yet exist, so set its value
-			this->SetCoefficient(this->GetCoefficient(i), i + 1);
+			std::vector<C> q;
+			std::vector<C> remainder;
+			PolynomialKernels::DivideRemainder(std::vector<C>(r, r + n), std::vector<C>(b, b + m), q, remainder, multiply);
+
+			std::copy(remainder.begin(), remainder.end(), r);
+			std::copy(q.begin(), q.end(), r + remainderSize);
 		}
 		else
 		{
-			//Higher expoent exists, so add to its value
-			this->SetCoefficient(this->GetCoefficient(i) + this->GetCoefficient(i + 1), i + 1);
+			PolynomialKernels::DivideInPlace(r, n, b, m);
+		}
+	}
+
+	if (quotient == this)
+	{
+		std::copy(r + remainderSize, r + n, r);
+		mutation.Resize(std::max<std::size_t>(quotientSize, 1));
+
+		if (quotientSize == 0)
+		{
+			mutation[0] = C(0);
+		}
+
+		return;
+	}
+
+	if (quotient != nullptr)
+	{
+		Mutation q(*quotient);
+		q.Resize(std::max<std::size_t>(quotientSize, 1));
+
+		std::copy(r + remainderSize, r + remainderSize + quotientSize, q.Data());
+		if (quotientSize == 0)
+		{
+			q[0] = C(0);
 		}
+	}
 
-		//Calculate current exponent value
-		this->SetCoefficient(this->GetCoefficient(i) * root * -1, i);
+	mutation.Resize(std::max<std::size_t>(remainderSize, 1));
+	if (remainderSize == 0)
+	{
+		mutation[0] = C(0);
 	}
 }
 
-/*
-	Valuates the polynomial at a given point.
-	Solves requirement 1f.
-*/
-template <typename C> C Polynomial<C>::ValueAt(const C x) const
+//Computes quotient and remainder of dividing by divisor at once.
+template <typename C> void Polynomial<C>::DivMod(const Polynomial<C>& divisor, Polynomial<C>& quotient, Polynomial<C>& remainder) const
 {
-	C res = 0;
+	assert(&quotient != &remainder);
 
-	//Calculate the value for the given x
-	for (auto i = 0; i <= this->GetHighestCoefficient(); i++)
+	//The remainder is overwritten before the division, so a divisor in its place is copied first
+	if (&divisor == &remainder)
 	{
-		res += this->GetCoefficient(i) * std::pow(x, i);
+		const Polynomial<C> divisorCopy(divisor);
+		this->DivMod(divisorCopy, quotient, remainder);
+		return;
 	}
 
-	return res;
+	remainder = *this;
+	remainder.DivideInPlace(divisor, &quotient);
 }
 
-/*
-	Computes a polynomial which is a derivative of this polynomial.
-	Solves requirement 1g.
-*/
-template <typename C> Polynomial<C> Polynomial<C>::CalculateDerivative() const
+//Copy assignment
+template <typename C> Polynomial<C>& Polynomial<C>::operator=(const Polynomial& p)
 {
-	//Prepare derivative polynomial by copying current one
-	Polynomial p(*this);
+	this->Impl() = p.Impl();
+	return *this;
+}
 
-	//Calculate derivative polynomial
-	for (auto i = 0; i < p.GetHighestCoefficient(); i++)
-	{
-		p.SetCoefficient(p.GetCoefficient(i + 1) * (i + 1), i);
-	}
+//Move assignment, leaves p without coefficients
+template <typename C> Polynomial<C>& Polynomial<C>::operator=(Polynomial<C>&& p)
+{
+	this->Impl() = std::move(p.Impl());
+	return *this;
+}
 
-	//Erase highest exponent, as it is now invalidated
-	p.pImpl->coefficients.erase(p.pImpl->coefficients.end() - 1);
+//Gets the thresholds used to pick a multiplication algorithm for this coefficient type.
+template <typename C> MultiplicationThresholds Polynomial<C>::GetMultiplicationThresholds()
+{
+	return { karatsubaThreshold.load(), fftThreshold.load() };
+}
 
-	return p;
+//Sets the thresholds used to pick a multiplication algorithm for this coefficient type.
+template <typename C> void Polynomial<C>::SetMultiplicationThresholds(const MultiplicationThresholds thresholds)
+{
+	karatsubaThreshold.store(thresholds.karatsuba);
+	fftThreshold.store(thresholds.fft);
 }
 
-/*
-	Integral tag dispatch, used for requirement 8.
-*/
-template <typename C> C Polynomial<C>::CalculateIntegralDispatch(const C a, const C b, std::true_type) const
+//Gets the size from which batched evaluation and interpolation use a subproduct tree for this coefficient type.
+template <typename C> std::size_t Polynomial<C>::GetMultipointThreshold()
 {
-	/*
-		Fail assertion for int types on integral data.
-		Used for requirement 8.
-	*/
-	std::cout << "Error: Integrals for integer types are not supported" << std::endl;
-	assert(false);
+	return multipointThreshold.load();
+}
+
+//Sets the size from which batched evaluation and interpolation use a subproduct tree for this coefficient type.
+template <typename C> void Polynomial<C>::SetMultipointThreshold(const std::size_t threshold)
+{
+	multipointThreshold.store(threshold);
 }
 
 /*
-	Integral tag dispatch, used for requirement 8.
+	Creates the polynomial through the given points.
+	The subproduct tree path needs exact division by the Lagrange denominators, so integer types always use Newton.
 */
-template <typename C> C Polynomial<C>::CalculateIntegralDispatch(const C a, const C b, std::false_type) const
+template <typename C> Polynomial<C> Polynomial<C>::Interpolate(const C* xFirst, const C* xLast, const C* yFirst)
 {
-	auto p = this;
+	const auto n = static_cast<std::size_t>(xLast - xFirst);
 
-	/*
-		Lambda expression used to calculate one part of an integral.
-		Solves requirement 9.
+	Polynomial<C> p;
 
-		In addition, I'm using auto here to deduce types.
-		This solves requirement 3.
+	if (n == 0)
+	{
+		return p;
+	}
 
-		Furthermore, it caches its results to minimize calculations. This is thread-safe.
-		Solves requirement 6.
-	*/
-	auto IntegralPart = [p](const auto n){
-		auto res = 0.;
+	{
+		Mutation m(p);
+		m.Resize(n);
+
+		auto fast = !std::is_integral<C>::value && n >= multipointThreshold.load(std::memory_order_relaxed);
+		auto distinct = fast
+			? PolynomialKernels::InterpolateFast(xFirst, yFirst, n, m.Data(), CurrentMultiplier<C>())
+			: PolynomialKernels::InterpolateNewton(xFirst, yFirst, n, m.Data());
 
-		if (p->pImpl->integralData.count(n) > 0) //key exists, set only once
+		if (!distinct)
 		{
-			std::cout << "Retrieving: " << n << " from integral cache..." << std::endl;
-			res = p->pImpl->integralData.find(n)->second;	
+			throw std::invalid_argument("Interpolation points must be distinct");
 		}
-		else //key doesn't exist, Calculate...
-		{	
-			//Lock cache, as we want to alter it
-			std::lock_guard<std::mutex> lock(p->integralGuard);
-
-			//Calculate integral
-			for (auto i = 0; i <= p->GetHighestCoefficient(); i++)
-			{
-				res += p->GetCoefficient(i) * std::pow(n, i + 1) / (i + 1);
-			}
+	}
 
-			//Store in cache
-			p->pImpl->integralData.insert({ n, res });
-		}
+	return p;
+}
 
-		return res;
-	};
+/*
+	Returns a polynomial equal to the sum of this and given polynomial.
+	Solves requirement 1i.
+*/
+template <typename C> Polynomial<C> Polynomial<C>::operator+(const Polynomial<C>& rhs) const &
+{
+	Polynomial<C> p(*this);
 
-	/*
-		Run the integral part lambda concurrently.
-		Solves requirement 10.
-	*/
-	auto partB = std::async(IntegralPart, b);
-	auto partA = std::async(IntegralPart, a);
+	p += rhs;
 
-	//Get results from tasks
-	return partB.get() - partA.get();
+	return p;
 }
 
-/*
-	Computes an integral for the given interval bounds.
-	Solves requirement 1h.
-*/
-template <typename C> C Polynomial<C>::CalculateIntegral(const C a, const C b) const
+template <typename C> Polynomial<C> Polynomial<C>::operator+(const Polynomial<C>& rhs) &&
 {
-	/*
-		Integral tag dispatch using traits.
-		Solves requirement 8.
-	*/
-	typename std::is_integral<C>::type isIntergral;
-	return this->CalculateIntegralDispatch(a, b, isIntergral);
+	*this += rhs;
+
+	return std::move(*this);
 }
 
-/*******
-******** 	Operator overloads
-********/
+//Addition commutes, so the sum can be built in the temporary right hand side
+template <typename C> Polynomial<C> Polynomial<C>::operator+(Polynomial<C>&& rhs) const &
+{
+	rhs += *this;
 
-//Calculates the sum of this and a given polynomial
-template <typename C> Polynomial<C>& Polynomial<C>::operator+=(const Polynomial<C>& rhs)
+	return std::move(rhs);
+}
+
+template <typename C> Polynomial<C> Polynomial<C>::operator+(Polynomial<C>&& rhs) &&
 {
-	for (auto i = 0; i <= rhs.GetHighestCoefficient(); i++)
-	{
-		if (i <= this->GetHighestCoefficient())
-		{
-			this->SetCoefficient(rhs.GetCoefficient(i) + this->GetCoefficient(i), i);
-		}
-		else
-		{
-			this->SetCoefficient(rhs.GetCoefficient(i), i);
-		}
-	}
+	*this += rhs;
 
-	return *this;
+	return std::move(*this);
 }
 
-//Calculates the product of this and a given polynomial
-template <typename C> Polynomial<C>& Polynomial<C>::operator *=(const Polynomial<C>& rhs)
+/*
+	Returns a polynomial equal to the product of this and a given polynomial.
+	Solves requirement 1j.
+*/
+template <typename C> Polynomial<C> Polynomial<C>::operator*(const Polynomial<C>& rhs) const &
 {
-	//Make sure to clear cache before we alter the polynomial
-	std::lock_guard<std::mutex> lock(this->integralGuard);
-	this->pImpl->integralData.clear();
+	//Start out without coefficients, the product needs a buffer of its own anyway
+	Polynomial<C> p(std::initializer_list<C>{});
 
-	//Prepare new list
-	auto res = std::vector<C>(this->GetHighestCoefficient() + rhs.GetHighestCoefficient() + 1, 0);
+	p.AssignProduct(*this, rhs, GetDefaultExecutor());
 
-	//Calculate product
-	for (auto i = this->GetHighestCoefficient(); i >= 0; i--)
-	{
-		for (auto j = rhs.GetHighestCoefficient(); j >= 0; j--)
-		{
-			res[i + j] += this->GetCoefficient(i) * rhs.GetCoefficient(j);
-		}
-	}
+	return p;
+}
 
-	this->pImpl->coefficients = res;
+template <typename C> Polynomial<C> Polynomial<C>::operator*(const Polynomial<C>& rhs) &&
+{
+	this->AssignProduct(*this, rhs, GetDefaultExecutor());
 
-	return *this;
+	return std::move(*this);
 }
 
-//Copy assignment
-template <typename C> Polynomial<C>& Polynomial<C>::operator=(const Polynomial& p)
+template <typename C> Polynomial<C> Polynomial<C>::operator*(Polynomial<C>&& rhs) const &
 {
-	*this->pImpl = *p.pImpl;
-	return *this;
+	rhs.AssignProduct(*this, rhs, GetDefaultExecutor());
+
+	return std::move(rhs);
 }
 
-/*
-	Returns a polynomial equal to the sum of this and given polynomial.
-	Solves requirement 1i.
-*/
-template <typename C> Polynomial<C> Polynomial<C>::operator+(const Polynomial<C>& rhs)
+template <typename C> Polynomial<C> Polynomial<C>::operator*(Polynomial<C>&& rhs) &&
+{
+	this->AssignProduct(*this, rhs, GetDefaultExecutor());
+
+	return std::move(*this);
+}
+
+//Returns the quotient of this and a given polynomial.
+template <typename C> Polynomial<C> Polynomial<C>::operator/(const Polynomial<C>& rhs) const &
 {
 	Polynomial<C> p(*this);
 
-	p += rhs;
+	p /= rhs;
 
 	return p;
 }
 
-/*
-	Returns a polynomial equal to the product of this and a given polynomial.
-	Solves requirement 1j.
-*/
-template <typename C> Polynomial<C> Polynomial<C>::operator*(const Polynomial<C>& rhs)
+template <typename C> Polynomial<C> Polynomial<C>::operator/(const Polynomial<C>& rhs) &&
+{
+	*this /= rhs;
+
+	return std::move(*this);
+}
+
+//Returns the remainder of dividing this by a given polynomial.
+template <typename C> Polynomial<C> Polynomial<C>::operator%(const Polynomial<C>& rhs) const &
 {
 	Polynomial<C> p(*this);
 
-	p *= rhs;
+	p %= rhs;
 
 	return p;
 }
 
+template <typename C> Polynomial<C> Polynomial<C>::operator%(const Polynomial<C>& rhs) &&
+{
+	*this %= rhs;
+
+	return std::move(*this);
+}
+
 //Pretty print
 template <typename CO> std::ostream& operator<<(std::ostream& s, const Polynomial<CO>& p)
 {
 	s << "P(x) = ";
 
-	for (auto i = p.GetHighestCoefficient(); i >= 0; i--)
+	const auto data = p.Data();
+
+	for (auto i = p.Size(); i-- > 0;)
 	{
-		s << p.GetCoefficient(i);
+		s << (data != nullptr ? data[i] : p.GetCoefficient(static_cast<unsigned int>(i)));
 		if (i > 0)
 		{
 			if (i == 1)
@@ -397,3 +1509,12 @@ template class Polynomial<double>;
 
 template std::ostream& operator<< <long double>(std::ostream&, const Polynomial<long double>&);
 template class Polynomial<long double>;
+
+
+//Modular types, add further moduli here
+
+template std::ostream& operator<< <ModInt<998244353>>(std::ostream&, const Polynomial<ModInt<998244353>>&);
+template class Polynomial<ModInt<998244353>>;
+
+template std::ostream& operator<< <ModInt<1000000007>>(std::ostream&, const Polynomial<ModInt<1000000007>>&);
+template class Polynomial<ModInt<1000000007>>;
@@ -13,9 +13,52 @@
 #include <iostream>
 #include <vector>
 #include <cmath>
-#include <unordered_map>
-#include <future>
+#include <mutex>
 #include <cassert>
+#include <atomic>
+#include <memory>
+#include <algorithm>
+#include <type_traits>
+#include <complex>
+
+#include "Executor.h"
+#include "CoefficientBuffer.h"
+
+/*
+	Operand sizes, counted in coefficients of the shorter operand, from which multiplication
+	switches from schoolbook to Karatsuba, and from Karatsuba to FFT convolution.
+	Floating point types use a complex FFT. Modular and signed integer types use the exact number theoretic
+	transform, up to products of 2^25 coefficients, beyond which they fall back to Karatsuba.
+*/
+struct MultiplicationThresholds
+{
+	std::size_t karatsuba;
+	std::size_t fft;
+};
+
+/*
+	Options for Polynomial::FindRoots.
+*/
+struct RootFindingOptions
+{
+	//Largest correction, relative to max(1, |root|), at which a root counts as converged. 0 for a few units in the last place.
+	double tolerance = 0;
+
+	//Iterations after which the search stops, converged or not.
+	std::size_t maxIterations = 200;
+};
+
+/*
+	Roots found by Polynomial::FindRoots, with multiplicity and in no particular order.
+*/
+template <typename R> struct RootFindingResult
+{
+	std::vector<std::complex<R>> roots;
+
+	//Iterations used, and whether every root converged within the iteration cap
+	std::size_t iterations;
+	bool converged;
+};
 
 /*
 	This is a template class.
@@ -23,13 +66,24 @@
 */
 template <typename C> class Polynomial
 {
+public:
+	//Real type of the roots, see FindRoots. double for integer and modular coefficients.
+	typedef typename std::conditional<std::is_floating_point<C>::value, C, double>::type RootScalar;
+
 private:
 	/*
 		Pimpl idiom used for move semantics.
 		Solves requirement 7.
+
+		The implementation lives in storage reserved in the object itself, so creating, copying and moving
+		polynomials of degree below inlineCapacity doesn't allocate. Polynomial.cpp checks that PolynomialData fits.
 	*/
 	struct PolynomialData;
-	mutable std::unique_ptr<PolynomialData> pImpl;
+	static const std::size_t inlineCapacity = 9;
+	static const std::size_t dataSize = sizeof(CoefficientBuffer<C, inlineCapacity>) + 64;
+	mutable typename std::aligned_storage<dataSize, alignof(CoefficientBuffer<C, inlineCapacity>)>::type storage;
+
+	PolynomialData& Impl() const;
 
 
 	/*
@@ -38,6 +92,31 @@ private:
 	*/
 	mutable std::mutex integralGuard;
 
+	/*
+		Multiplication algorithm thresholds, tunable at runtime per coefficient type.
+	*/
+	static std::atomic<std::size_t> karatsubaThreshold;
+	static std::atomic<std::size_t> fftThreshold;
+
+	/*
+		Number of points and coefficients from which batched evaluation uses a remainder tree, tunable at runtime.
+	*/
+	static std::atomic<std::size_t> multipointThreshold;
+
+	//Sets this polynomial to the product of lhs and rhs, either of which may be this polynomial.
+	void AssignProduct(const Polynomial<C>& lhs, const Polynomial<C>& rhs, Executor& executor);
+
+	/*
+		Divides this polynomial by divisor in place, keeping the quotient if quotient is this polynomial,
+		and otherwise keeping the remainder and writing the quotient to quotient unless it is nullptr.
+	*/
+	void DivideInPlace(const Polynomial<C>& divisor, Polynomial<C>* quotient);
+
+	//Multiplies the polynomial with the linear factors (x - root) of all the given roots.
+	void AddRoots(const std::vector<C>& roots);
+
+	//Gets the antiderivative of the current coefficients, building and caching it if needed.
+	const Polynomial<C>& GetAntiderivative() const;
 
 
 	/*
@@ -46,13 +125,64 @@ private:
 	C CalculateIntegralDispatch(const C a, const C b, std::true_type) const;
 	C CalculateIntegralDispatch(const C a, const C b, std::false_type) const;
 
+	/*
+		Root finding tag dispatch on std::is_arithmetic, as modular coefficients have no complex roots to approximate.
+		The arithmetic overload is a member template, so explicit instantiations for modular types leave it out.
+	*/
+	template <typename D = C> RootFindingResult<RootScalar> FindRootsDispatch(const RootFindingOptions& options, std::true_type) const;
+	RootFindingResult<RootScalar> FindRootsDispatch(const RootFindingOptions& options, std::false_type) const;
+
+	/*
+		Evaluates the antiderivative at every point in [first, last), used by the batched integrals.
+		Uses the same tag dispatch as the integral.
+	*/
+	void AntiderivativeRangeDispatch(const C* first, const C* last, C* out, std::true_type) const;
+	void AntiderivativeRangeDispatch(const C* first, const C* last, C* out, std::false_type) const;
+
 public:
+	/*
+		Batch of changes to a polynomial, giving direct access to its coefficient buffer.
+		It holds integralGuard for its whole lifetime, and invalidates the caches once when it ends,
+		instead of once per coefficient. Sparse polynomials are expanded to dense storage while it lasts.
+		Don't use the polynomial itself until the mutation has ended.
+	*/
+	class Mutation
+	{
+	private:
+		Polynomial<C>* polynomial;
+		std::unique_lock<std::mutex> lock;
+		CoefficientBuffer<C, inlineCapacity>* coefficients;
+
+	public:
+		explicit Mutation(Polynomial<C>& p);
+		Mutation(Mutation&& m);
+		~Mutation();
+
+		//Number of coefficients, i.e. highest exponent + 1
+		std::size_t Size() const { return this->coefficients->size(); }
+
+		//Changes the number of coefficients, new coefficients are 0
+		void Resize(const std::size_t size) { this->coefficients->resize(size, C(0)); }
+
+		//Contiguous coefficient buffer, lowest exponent first
+		C* Data() { return this->coefficients->data(); }
+
+		C& operator[](const std::size_t exponent) { return (*this->coefficients)[exponent]; }
+	};
+
 	/*
 		Default constructor
 		Creates a trivial Polynomial. Solves requirement 1a.
 	*/
 	Polynomial();
 
+	/*
+		Creates a trivial Polynomial taking its coefficient memory from the given resource, see MemoryResource.h.
+		Other constructors use the calling thread's default resource, except the move constructor
+		which keeps the resource of p.
+	*/
+	explicit Polynomial(MemoryResource* resource);
+
 	//Copy constructor
 	Polynomial(const Polynomial<C>& p); 
 
@@ -78,18 +208,41 @@ public:
 	//Sets a coefficient of the form: value * x^exponent
 	void SetCoefficient(const C value, const unsigned int exponent);
 
+	//Starts a batch of changes, see Mutation.
+	Mutation Mutate();
+
 	/*
 		Scales the polynomial by the given value.
 		Solves requirement 1c.
 	*/
 	void Scale(const C scalar);
 
+	//Scales the polynomial, with the coefficients split across the executor of the policy, see ExecutionPolicy.
+	void Scale(const ExecutionPolicy& policy, const C scalar);
+
 	/*
 		Adds a root to the polynomial (by multiplying with x - root).
 		Solves requirement 1d.
 	*/
 	void AddRoot(const C root);
 
+	/*
+		Replaces the polynomial p by p(x + a), a Taylor shift.
+		Small degrees shift in place in O(n^2), larger ones compose with x + a by divide and conquer
+		on top of fast multiplication.
+	*/
+	void Shift(const C a);
+
+	//Replaces the polynomial p by p(s * x + t), shifting by t and then scaling each coefficient by a power of s.
+	void Affine(const C s, const C t);
+
+	/*
+		Replaces the polynomial p by the composition p(q(x)).
+		Uses divide and conquer, p(q) = low(q) + q^h high(q), with fast multiplication and the powers of q
+		computed once, O(M(nm) log n) for n and m coefficients.
+	*/
+	void Compose(const Polynomial<C>& q);
+
 	/*
 		Valuates the polynomial at a given point.
 		Solves requirement 1f.
@@ -102,6 +255,18 @@ public:
 	*/
 	C ValueAt(const C x) const;
 
+	/*
+		Valuates the polynomial at every point in [first, last), writing the results to out.
+		Uses SIMD kernels for float and double: AVX-512 in builds targeting it, and otherwise, with GCC on x86,
+		AVX2 and FMA kernels picked at run time when the processor supports them. Elsewhere it runs Horner on
+		8 points at a time, which the compiler may vectorize.
+
+		When both the number of points and coefficients reach the multipoint threshold,
+		it switches to fast multipoint evaluation with a remainder tree. By default this
+		only happens for integer types, see SetMultipointThreshold.
+	*/
+	void ValueAtRange(const C* first, const C* last, C* out) const;
+
 
 	
 	//Gets a coefficient for a specific exponent.
@@ -110,6 +275,18 @@ public:
 	//Gets the coefficient for the highest exponent.
 	C GetHighestCoefficient() const;
 
+	//Gets the number of coefficients, i.e. highest exponent + 1.
+	std::size_t Size() const;
+
+	//Gets the resource the coefficients take their memory from.
+	MemoryResource* GetResource() const;
+
+	/*
+		Contiguous coefficient buffer, lowest exponent first, for reading many coefficients at once.
+		Returns nullptr when the polynomial is stored sparse. The buffer is valid until the polynomial is altered.
+	*/
+	const C* Data() const;
+
 
 
 	/*
@@ -118,24 +295,55 @@ public:
 	*/
 	Polynomial<C> CalculateDerivative() const;
 
+	//Computes the derivative, with the coefficients split across the executor of the policy.
+	Polynomial<C> CalculateDerivative(const ExecutionPolicy& policy) const;
+
 	/*
 		Computes an integral for the given interval bounds.
+		Throws std::domain_error for integer types.
 		Solves requirement 1h.
 	*/
 	C CalculateIntegral(const C a, const C b) const;
 
+	/*
+		Computes the integrals over the intervals [a[i], b[i]] for the bounds a in [aFirst, aLast) and the matching b from bFirst.
+		The antiderivative is evaluated once for each distinct bound, using the batched evaluation.
+		Throws std::domain_error for integer types.
+	*/
+	void CalculateIntegralRange(const C* aFirst, const C* aLast, const C* bFirst, C* out) const;
+
+	/*
+		Computes the integral over each bin between consecutive breakpoints in [first, last),
+		writing last - first - 1 areas to out. Every breakpoint is evaluated once.
+		Throws std::domain_error for integer types.
+	*/
+	void CalculateIntegralBins(const C* first, const C* last, C* out) const;
+
+	/*
+		Finds all complex roots, the inverse of AddRootRange, by Aberth-Ehrlich iteration.
+		Each iteration is O(n^2), updates all roots independently across the executor, and
+		typically a few dozen iterations are needed. Roots at 0 are split off exactly first.
+		Multiple roots converge slowly and only to a fraction of the precision, so check converged.
+		Polynomials without a nonzero coefficient above the constant have no roots.
+		Throws std::domain_error for coefficient types that aren't numbers on the real line, like ModInt.
+	*/
+	RootFindingResult<RootScalar> FindRoots(const RootFindingOptions& options = RootFindingOptions()) const;
+
 	/*
 		Sets a range of coefficients, see SetCoefficient. Supports any type of container through const_iterator.
 		Solves requirement 5.
 	*/
 	template<typename T> void SetCoefficientRange(typename T::const_iterator first, typename T::const_iterator last, const unsigned int offset = 0)
 	{
-		auto exponent = offset;
-		while (first + exponent - offset != last)
+		Mutation m(*this);
+
+		const std::size_t end = offset + (last - first);
+		if (end > m.Size())
 		{
-			this->SetCoefficient(*(first + exponent - offset), exponent);
-			exponent++;
+			m.Resize(end);
 		}
+
+		std::copy(first, last, m.Data() + offset);
 	}
 
 	/*
@@ -144,14 +352,13 @@ public:
 
 		Furthermore, it supports any type of container through const_iterator.
 		This solves requirement 5.
+
+		The linear factors are multiplied together in a balanced product tree first,
+		and the result is then multiplied onto this polynomial using the multiplication engine.
 	*/
 	template<typename T> void AddRootRange(typename T::const_iterator first, typename T::const_iterator last)
 	{
-		while (first != last)
-		{
-			this->AddRoot(*first);
-			first++;
-		}
+		this->AddRoots(std::vector<C>(first, last));
 	}
 
 
@@ -162,22 +369,100 @@ public:
 	//Calculates the product of this and a given polynomial
 	Polynomial<C>& operator*=(const Polynomial<C>& rhs);
 
+	/*
+		operator+= and operator*= with an execution policy, see ExecutionPolicy.
+		With Execution::par the sum is split into coefficient ranges, and the product splits schoolbook
+		output tiles, Karatsuba sub-products or FFT stages across the executor. Execution::seq stays on the
+		calling thread. The operators themselves add sequentially and multiply on the default executor.
+	*/
+	Polynomial<C>& Add(const ExecutionPolicy& policy, const Polynomial<C>& rhs);
+	Polynomial<C>& Multiply(const ExecutionPolicy& policy, const Polynomial<C>& rhs);
+
+	/*
+		Divides by a given polynomial, keeping the quotient or the remainder, see DivMod.
+		These work in the buffer of this polynomial, so they don't allocate below the Newton division sizes.
+	*/
+	Polynomial<C>& operator/=(const Polynomial<C>& rhs);
+	Polynomial<C>& operator%=(const Polynomial<C>& rhs);
+
 	//Copy assignment
 	Polynomial<C>& operator=(const Polynomial<C>& p);
 
+	//Move assignment, leaves p without coefficients
+	Polynomial<C>& operator=(Polynomial<C>&& p);
+
+
+
+	//Gets the thresholds used to pick a multiplication algorithm for this coefficient type.
+	static MultiplicationThresholds GetMultiplicationThresholds();
+
+	//Sets the thresholds used to pick a multiplication algorithm for this coefficient type.
+	static void SetMultiplicationThresholds(const MultiplicationThresholds thresholds);
+
+	//Gets the size from which batched evaluation and interpolation use a subproduct tree for this coefficient type.
+	static std::size_t GetMultipointThreshold();
+
+	//Sets the size from which batched evaluation and interpolation use a subproduct tree for this coefficient type.
+	static void SetMultipointThreshold(const std::size_t threshold);
+
+	/*
+		Creates the polynomial of lowest degree through the points (x[i], y[i]), for x in [xFirst, xLast)
+		and the matching y from yFirst. Throws std::invalid_argument if two x coincide.
+		Uses Newton divided differences, O(n^2), computed directly in the coefficient buffer. From the multipoint
+		threshold on, floating point and modular types use fast interpolation on a subproduct tree, O(M(n) log n).
+		In floating point it loses precision quickly with the number of points, so there it is off until the threshold
+		is set explicitly. Integer types are exact when the interpolating polynomial has integer coefficients.
+	*/
+	static Polynomial<C> Interpolate(const C* xFirst, const C* xLast, const C* yFirst);
+
 
 
 	/*
 		Returns a polynomial equal to the sum of this and given polynomial.
 		Solves requirement 1i.
+
+		The rvalue overloads add into a temporary operand and return it, so chained sums don't copy.
 	*/
-	Polynomial<C> operator+(const Polynomial<C>& rhs);
+	Polynomial<C> operator+(const Polynomial<C>& rhs) const &;
+	Polynomial<C> operator+(const Polynomial<C>& rhs) &&;
+	Polynomial<C> operator+(Polynomial<C>&& rhs) const &;
+	Polynomial<C> operator+(Polynomial<C>&& rhs) &&;
 
 	/*
 		Returns a polynomial equal to the product of this and a given polynomial.
 		Solves requirement 1j.
+
+		The product is written straight into the result, and the rvalue overloads reuse a temporary operand as the result.
+
+		Integer products are exact: they throw std::overflow_error instead of overflowing. Coefficients are checked
+		exactly up to products of 2^25 coefficients. Beyond that, a product throws if min(n, m) * max |a| * max |b|
+		doesn't fit the coefficient type, for operands of n and m coefficients.
+	*/
+	Polynomial<C> operator*(const Polynomial<C>& rhs) const &;
+	Polynomial<C> operator*(const Polynomial<C>& rhs) &&;
+	Polynomial<C> operator*(Polynomial<C>&& rhs) const &;
+	Polynomial<C> operator*(Polynomial<C>&& rhs) &&;
+
+	//Returns the quotient of this and a given polynomial, see DivMod.
+	Polynomial<C> operator/(const Polynomial<C>& rhs) const &;
+	Polynomial<C> operator/(const Polynomial<C>& rhs) &&;
+
+	//Returns the remainder of dividing this by a given polynomial, see DivMod.
+	Polynomial<C> operator%(const Polynomial<C>& rhs) const &;
+	Polynomial<C> operator%(const Polynomial<C>& rhs) &&;
+
+	/*
+		Divides this polynomial by divisor, so that this = quotient * divisor + remainder,
+		with the remainder of lower degree than the divisor. Throws std::domain_error for a zero divisor.
+		Uses long division for small operands, and Newton iteration for the reciprocal of the divisor
+		on top of fast multiplication once quotient and divisor both reach twice the Karatsuba threshold.
+		The results reuse the buffers of quotient and remainder, which must be different polynomials.
+		Either of them may be the divisor.
+
+		With integer coefficients the identity only holds when the leading coefficient of the divisor
+		divides the coefficients it meets, e.g. for monic divisors.
 	*/
-	Polynomial<C> operator*(const Polynomial<C>& rhs);
+	void DivMod(const Polynomial<C>& divisor, Polynomial<C>& quotient, Polynomial<C>& remainder) const;
 };
 
 //Pretty print
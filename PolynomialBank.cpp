@@ -0,0 +1,69 @@
+/*
+	Name: 			Michael Lausdahl Fuglsang
+	email:			mfugls11
+	Study No.:		20112699
+
+	Code also available at:
+	https://github.com/Malakahh/Ap-exam-part-2
+*/
+
+#include "PolynomialBank.h"
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+/*******
+******** 	MappedFile
+********/
+
+MappedFile::MappedFile(const std::string& path) : data(nullptr), size(0)
+{
+	const auto fd = open(path.c_str(), O_RDONLY);
+
+	if (fd < 0)
+	{
+		throw std::runtime_error("Failed opening " + path);
+	}
+
+	struct stat info;
+	if (fstat(fd, &info) != 0)
+	{
+		close(fd);
+		throw std::runtime_error("Failed reading the size of " + path);
+	}
+
+	this->size = static_cast<std::size_t>(info.st_size);
+
+	//Empty files can't be mapped, and are left without data
+	if (this->size > 0)
+	{
+		auto memory = mmap(nullptr, this->size, PROT_READ, MAP_SHARED, fd, 0);
+
+		if (memory == MAP_FAILED)
+		{
+			close(fd);
+			throw std::runtime_error("Failed mapping " + path);
+		}
+
+		this->data = memory;
+	}
+
+	//The mapping stays valid after the descriptor is closed
+	close(fd);
+}
+
+MappedFile::MappedFile(MappedFile&& f) : data(f.data), size(f.size)
+{
+	f.data = nullptr;
+	f.size = 0;
+}
+
+MappedFile::~MappedFile()
+{
+	if (this->data != nullptr)
+	{
+		munmap(const_cast<void*>(this->data), this->size);
+	}
+}
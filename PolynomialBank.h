@@ -0,0 +1,420 @@
+/*
+	Name: 			Michael Lausdahl Fuglsang
+	email:			mfugls11
+	Study No.:		20112699
+
+	Code also available at:
+	https://github.com/Malakahh/Ap-exam-part-2
+*/
+
+#ifndef _POLYNOMIAL_BANK
+#define _POLYNOMIAL_BANK
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <iostream>
+#include <stdexcept>
+#include <iterator>
+#include <limits>
+#include <algorithm>
+
+#include "Polynomial.h"
+#include "PolynomialKernels.h"
+
+/*
+	Binary format for banks of polynomials, version 1:
+
+		Header				32 bytes, see BankHeader
+		Table				count entries of (offset, size) as uint64, one per polynomial
+		Coefficients		size coefficients per polynomial, lowest exponent first, each
+							run starting at its offset from the beginning of the bank,
+							aligned to bankAlignment
+
+	Values are stored in the byte order of the writer, which readers check through the header.
+	Coefficients are contiguous and aligned, so a bank can be used in place, e.g. from a memory mapped file.
+*/
+namespace PolynomialBankFormat
+{
+	const std::uint32_t version = 1;
+	const std::uint32_t byteOrderMark = 0x01020304;
+	const std::size_t bankAlignment = 16;
+
+	//Coefficients read from a stream at a time, so a corrupt size fails at the end of the stream instead of allocating it all
+	const std::size_t readChunkSize = 1 << 16;
+
+	struct BankHeader
+	{
+		char magic[4];
+		std::uint32_t byteOrder;
+		std::uint32_t version;
+		std::uint32_t typeTag;
+		std::uint32_t coefficientSize;
+		std::uint32_t reserved;
+		std::uint64_t count;
+	};
+
+	struct TableEntry
+	{
+		std::uint64_t offset;
+		std::uint64_t size;
+	};
+
+	static_assert(sizeof(BankHeader) == 32 && sizeof(TableEntry) == 16, "Bank layout must not contain padding");
+
+	//Coefficient type tags
+	template <typename C> struct TypeTag;
+	template <> struct TypeTag<int> { static const std::uint32_t value = 1; };
+	template <> struct TypeTag<float> { static const std::uint32_t value = 2; };
+	template <> struct TypeTag<double> { static const std::uint32_t value = 3; };
+	template <> struct TypeTag<long double> { static const std::uint32_t value = 4; };
+
+	inline std::uint64_t Align(const std::uint64_t offset)
+	{
+		return (offset + bankAlignment - 1) / bankAlignment * bankAlignment;
+	}
+
+	template <typename C> BankHeader MakeHeader(const std::uint64_t count)
+	{
+		return { { 'P', 'L', 'Y', 'B' }, byteOrderMark, version, TypeTag<C>::value, sizeof(C), 0, count };
+	}
+
+	//Checks a header read from a bank of C coefficients, throwing std::runtime_error if it doesn't match
+	template <typename C> void CheckHeader(const BankHeader& header)
+	{
+		if (std::memcmp(header.magic, "PLYB", 4) != 0)
+		{
+			throw std::runtime_error("Not a polynomial bank");
+		}
+
+		if (header.byteOrder != byteOrderMark)
+		{
+			throw std::runtime_error("Polynomial bank was written with another byte order");
+		}
+
+		if (header.version != version)
+		{
+			throw std::runtime_error("Unsupported polynomial bank version");
+		}
+
+		if (header.typeTag != TypeTag<C>::value || header.coefficientSize != sizeof(C))
+		{
+			throw std::runtime_error("Polynomial bank holds another coefficient type");
+		}
+	}
+}
+
+/*
+	Read-only view of the coefficients of a polynomial stored elsewhere, e.g. in a PolynomialBank.
+	It is a pointer and a size, so it is cheap to copy, and must not outlive the memory it views.
+*/
+template <typename C> class PolynomialView
+{
+private:
+	const C* coefficients;
+	std::size_t size;
+
+public:
+	PolynomialView(const C* coefficients, const std::size_t size) : coefficients(coefficients), size(size) {}
+
+	//Gets a coefficient for a specific exponent.
+	C GetCoefficient(const std::size_t exponent) const
+	{
+		if (exponent >= this->size)
+		{
+			throw std::out_of_range("Index out of bounds");
+		}
+
+		return this->coefficients[exponent];
+	}
+
+	//Gets the highest exponent.
+	std::size_t GetHighestCoefficient() const { return this->size - 1; }
+
+	//Number of coefficients, i.e. highest exponent + 1.
+	std::size_t Size() const { return this->size; }
+
+	//Contiguous coefficient buffer, lowest exponent first.
+	const C* Data() const { return this->coefficients; }
+
+	//Valuates the polynomial at a given point.
+	C ValueAt(const C x) const
+	{
+		return PolynomialKernels::Evaluate(this->coefficients, this->size, x);
+	}
+
+	//Valuates the polynomial at every point in [first, last), writing the results to out.
+	void ValueAtRange(const C* first, const C* last, C* out) const
+	{
+		PolynomialKernels::EvaluateBatch(this->coefficients, this->size, first, out, static_cast<std::size_t>(last - first));
+	}
+
+	//Copies the coefficients into a Polynomial.
+	Polynomial<C> ToPolynomial() const
+	{
+		Polynomial<C> p(std::initializer_list<C>{});
+
+		{
+			auto m = p.Mutate();
+			m.Resize(this->size);
+			std::copy(this->coefficients, this->coefficients + this->size, m.Data());
+		}
+
+		return p;
+	}
+};
+
+/*
+	Read-only view of a bank in memory, e.g. a memory mapped file. Nothing is copied, and the
+	polynomials are checked against the bounds of the memory when the view is created.
+	Throws std::runtime_error if the memory doesn't hold a valid bank of C coefficients.
+*/
+template <typename C> class PolynomialBankView
+{
+private:
+	const unsigned char* data;
+	const PolynomialBankFormat::TableEntry* table;
+	std::size_t count;
+
+public:
+	PolynomialBankView(const void* data, const std::size_t bytes) : data(static_cast<const unsigned char*>(data)), table(nullptr), count(0)
+	{
+		using namespace PolynomialBankFormat;
+
+		if (bytes < sizeof(BankHeader) || reinterpret_cast<std::uintptr_t>(data) % bankAlignment != 0)
+		{
+			throw std::runtime_error("Polynomial bank is truncated or misaligned");
+		}
+
+		BankHeader header;
+		std::memcpy(&header, this->data, sizeof(header));
+		CheckHeader<C>(header);
+
+		if (header.count > (bytes - sizeof(BankHeader)) / sizeof(TableEntry))
+		{
+			throw std::runtime_error("Polynomial bank is truncated");
+		}
+
+		this->count = static_cast<std::size_t>(header.count);
+		this->table = reinterpret_cast<const TableEntry*>(this->data + sizeof(BankHeader));
+
+		for (std::size_t i = 0; i < this->count; i++)
+		{
+			const auto& entry = this->table[i];
+
+			if (entry.size == 0 || entry.offset % bankAlignment != 0 || entry.offset > bytes || entry.size > (bytes - entry.offset) / sizeof(C))
+			{
+				throw std::runtime_error("Polynomial bank entry is out of bounds");
+			}
+		}
+	}
+
+	//Number of polynomials in the bank.
+	std::size_t Count() const { return this->count; }
+
+	//Gets a view of the polynomial at the given index.
+	PolynomialView<C> operator[](const std::size_t index) const
+	{
+		if (index >= this->count)
+		{
+			throw std::out_of_range("Index out of bounds");
+		}
+
+		const auto& entry = this->table[index];
+
+		return PolynomialView<C>(reinterpret_cast<const C*>(this->data + entry.offset), static_cast<std::size_t>(entry.size));
+	}
+};
+
+/*
+	Read-only memory mapping of a whole file. The pages are shared with other processes mapping the same file.
+	Throws std::runtime_error if the file can't be opened or mapped.
+*/
+class MappedFile
+{
+private:
+	const void* data;
+	std::size_t size;
+
+public:
+	explicit MappedFile(const std::string& path);
+
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+
+	MappedFile(MappedFile&& f);
+
+	~MappedFile();
+
+	const void* Data() const { return this->data; }
+	std::size_t Size() const { return this->size; }
+};
+
+/*
+	Bank of polynomials opened from a file through a memory mapping.
+*/
+template <typename C> class PolynomialBank
+{
+private:
+	MappedFile file;
+	PolynomialBankView<C> view;
+
+public:
+	explicit PolynomialBank(const std::string& path) : file(path), view(file.Data(), file.Size()) {}
+
+	//Number of polynomials in the bank.
+	std::size_t Count() const { return this->view.Count(); }
+
+	//Gets a view of the polynomial at the given index.
+	PolynomialView<C> operator[](const std::size_t index) const { return this->view[index]; }
+};
+
+/*
+	Writes the polynomials in [first, last) to a stream as a bank. Open file streams in binary mode.
+*/
+template <typename It> void WritePolynomialBank(std::ostream& out, It first, It last)
+{
+	using namespace PolynomialBankFormat;
+	typedef typename std::decay<decltype(first->GetCoefficient(0))>::type C;
+
+	auto table = std::vector<TableEntry>();
+	auto offset = Align(sizeof(BankHeader) + std::distance(first, last) * sizeof(TableEntry));
+
+	for (auto it = first; it != last; it++)
+	{
+		table.push_back({ offset, it->Size() });
+		offset = Align(offset + it->Size() * sizeof(C));
+	}
+
+	const auto header = MakeHeader<C>(table.size());
+	out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	out.write(reinterpret_cast<const char*>(table.data()), table.size() * sizeof(TableEntry));
+
+	const char padding[bankAlignment] = {};
+	std::uint64_t position = sizeof(BankHeader) + table.size() * sizeof(TableEntry);
+	std::size_t index = 0;
+
+	for (auto it = first; it != last; it++, index++)
+	{
+		out.write(padding, table[index].offset - position);
+
+		//Sparse polynomials have no buffer, and are written one coefficient at a time
+		if (it->Data() != nullptr)
+		{
+			out.write(reinterpret_cast<const char*>(it->Data()), it->Size() * sizeof(C));
+		}
+		else
+		{
+			for (std::size_t i = 0; i < it->Size(); i++)
+			{
+				const C c = it->GetCoefficient(static_cast<unsigned int>(i));
+				out.write(reinterpret_cast<const char*>(&c), sizeof(C));
+			}
+		}
+
+		position = table[index].offset + it->Size() * sizeof(C);
+	}
+
+	if (!out)
+	{
+		throw std::runtime_error("Failed writing polynomial bank");
+	}
+}
+
+/*
+	Reads a whole bank from a stream into polynomials. Open file streams in binary mode.
+	Throws std::runtime_error if the stream doesn't hold a valid bank of C coefficients.
+*/
+template <typename C> std::vector<Polynomial<C>> ReadPolynomialBank(std::istream& in)
+{
+	using namespace PolynomialBankFormat;
+
+	BankHeader header;
+	if (!in.read(reinterpret_cast<char*>(&header), sizeof(header)))
+	{
+		throw std::runtime_error("Polynomial bank is truncated");
+	}
+
+	CheckHeader<C>(header);
+
+	auto table = std::vector<TableEntry>();
+	std::uint64_t position = sizeof(BankHeader);
+
+	for (std::uint64_t i = 0; i < header.count; i++)
+	{
+		TableEntry entry;
+		if (!in.read(reinterpret_cast<char*>(&entry), sizeof(entry)))
+		{
+			throw std::runtime_error("Polynomial bank is truncated");
+		}
+
+		table.push_back(entry);
+		position += sizeof(entry);
+	}
+
+	auto polynomials = std::vector<Polynomial<C>>();
+	polynomials.reserve(table.size());
+
+	for (auto& entry : table)
+	{
+		//Every polynomial has a coefficient, and the byte count of the coefficients must fit
+		if (entry.size == 0 || entry.size > std::numeric_limits<std::size_t>::max() / sizeof(C)
+			|| entry.size * sizeof(C) > std::numeric_limits<std::uint64_t>::max() - entry.offset)
+		{
+			throw std::runtime_error("Polynomial bank entry has an invalid size");
+		}
+
+		//Entries are read in order, so the stream doesn't need to be seekable
+		if (entry.offset < position || !in.ignore(static_cast<std::streamsize>(entry.offset - position)))
+		{
+			throw std::runtime_error("Polynomial bank entry is out of order or truncated");
+		}
+
+		Polynomial<C> p(std::initializer_list<C>{});
+
+		{
+			auto m = p.Mutate();
+			const auto size = static_cast<std::size_t>(entry.size);
+
+			for (std::size_t done = 0; done < size;)
+			{
+				const auto n = std::min(readChunkSize, size - done);
+				m.Resize(done + n);
+
+				if (!in.read(reinterpret_cast<char*>(m.Data() + done), static_cast<std::streamsize>(n * sizeof(C))))
+				{
+					throw std::runtime_error("Polynomial bank is truncated");
+				}
+
+				done += n;
+			}
+		}
+
+		polynomials.push_back(std::move(p));
+		position = entry.offset + entry.size * sizeof(C);
+	}
+
+	return polynomials;
+}
+
+//Writes a single polynomial as a bank of one.
+template <typename C> void WritePolynomial(std::ostream& out, const Polynomial<C>& p)
+{
+	WritePolynomialBank(out, &p, &p + 1);
+}
+
+//Reads a single polynomial, the first of a bank.
+template <typename C> Polynomial<C> ReadPolynomial(std::istream& in)
+{
+	auto bank = ReadPolynomialBank<C>(in);
+
+	if (bank.empty())
+	{
+		throw std::runtime_error("Polynomial bank is empty");
+	}
+
+	return std::move(bank.front());
+}
+
+#endif
@@ -0,0 +1,235 @@
+/*
+	Name: 			Michael Lausdahl Fuglsang
+	email:			mfugls11
+	Study No.:		20112699
+
+	Code also available at:
+	https://github.com/Malakahh/Ap-exam-part-2
+*/
+
+#ifndef _POLYNOMIAL_BATCH
+#define _POLYNOMIAL_BATCH
+
+#include <cstddef>
+#include <vector>
+#include <iterator>
+#include <stdexcept>
+#include <algorithm>
+#include <type_traits>
+
+#include "Polynomial.h"
+#include "PolynomialKernels.h"
+
+/*
+	Many polynomials with the same number of coefficients, stored transposed as one array per exponent,
+	so coefficient k of every polynomial is contiguous. Evaluating the whole batch then runs Horner across
+	the polynomials, which vectorizes, instead of one polynomial and one scattered buffer at a time.
+
+	Polynomials of lower degree are padded with zero coefficients, so group polynomials of similar degree
+	into their own batches.
+*/
+template <typename C> class PolynomialBatch
+{
+private:
+	//Polynomials per tile, sized so a tile of accumulators stays in the L1 cache
+	static const std::size_t tileSize = 512;
+
+	std::size_t count;
+	std::size_t size;
+
+	//Coefficient k of polynomial j is at coefficients[k * count + j]
+	std::vector<C> coefficients;
+
+	//Runs body(begin, end) over tiles of polynomials, in parallel for large batches
+	template <typename F> void ForEachTile(const F& body) const
+	{
+		const auto tiles = (this->count + tileSize - 1) / tileSize;
+		const auto grain = std::max<std::size_t>(1, PolynomialKernels::parallelWorkThreshold / (tileSize * std::max<std::size_t>(this->size, 1)));
+
+		ParallelFor(GetDefaultExecutor(), tiles, grain, [&](const std::size_t first, const std::size_t last) {
+			for (auto t = first; t < last; t++)
+			{
+				body(t * tileSize, std::min(this->count, (t + 1) * tileSize));
+			}
+		});
+	}
+
+public:
+	//Creates a batch of count zero polynomials with size coefficients each.
+	PolynomialBatch(const std::size_t count, const std::size_t size) : count(count), size(size), coefficients(count * size, C(0)) {}
+
+	/*
+		Creates a batch from the polynomials in [first, last), with as many coefficients as the largest of them.
+	*/
+	template <typename It> PolynomialBatch(It first, It last) : count(static_cast<std::size_t>(std::distance(first, last))), size(0)
+	{
+		for (auto it = first; it != last; it++)
+		{
+			this->size = std::max(this->size, it->Size());
+		}
+
+		this->coefficients.assign(this->count * this->size, C(0));
+
+		std::size_t j = 0;
+		for (auto it = first; it != last; it++, j++)
+		{
+			this->Set(j, *it);
+		}
+	}
+
+	//Number of polynomials in the batch.
+	std::size_t Count() const { return this->count; }
+
+	//Number of coefficients of each polynomial, i.e. highest exponent + 1.
+	std::size_t Size() const { return this->size; }
+
+	//Gets coefficient exponent of the polynomial at index.
+	C GetCoefficient(const std::size_t index, const std::size_t exponent) const
+	{
+		if (index >= this->count || exponent >= this->size)
+		{
+			throw std::out_of_range("Index out of bounds");
+		}
+
+		return this->coefficients[exponent * this->count + index];
+	}
+
+	//Sets coefficient exponent of the polynomial at index.
+	void SetCoefficient(const std::size_t index, const C value, const std::size_t exponent)
+	{
+		if (index >= this->count || exponent >= this->size)
+		{
+			throw std::out_of_range("Index out of bounds");
+		}
+
+		this->coefficients[exponent * this->count + index] = value;
+	}
+
+	//Contiguous coefficients for an exponent, one per polynomial.
+	const C* Exponent(const std::size_t exponent) const { return this->coefficients.data() + exponent * this->count; }
+	C* Exponent(const std::size_t exponent) { return this->coefficients.data() + exponent * this->count; }
+
+	/*
+		Replaces the polynomial at index, padding it with zeros.
+		Throws std::out_of_range if the index is outside the batch or p has more coefficients than the batch.
+	*/
+	void Set(const std::size_t index, const Polynomial<C>& p)
+	{
+		if (index >= this->count || p.Size() > this->size)
+		{
+			throw std::out_of_range("Polynomial doesn't fit the batch");
+		}
+
+		const auto data = p.Data();
+
+		for (std::size_t k = 0; k < this->size; k++)
+		{
+			C c = 0;
+			if (k < p.Size())
+			{
+				c = data != nullptr ? data[k] : p.GetCoefficient(static_cast<unsigned int>(k));
+			}
+
+			this->coefficients[k * this->count + index] = c;
+		}
+	}
+
+	//Copies the polynomial at index out of the batch.
+	Polynomial<C> Get(const std::size_t index) const
+	{
+		if (index >= this->count)
+		{
+			throw std::out_of_range("Index out of bounds");
+		}
+
+		Polynomial<C> p(std::initializer_list<C>{});
+
+		{
+			auto m = p.Mutate();
+			m.Resize(this->size);
+
+			for (std::size_t k = 0; k < this->size; k++)
+			{
+				m[k] = this->coefficients[k * this->count + index];
+			}
+		}
+
+		return p;
+	}
+
+	//Valuates every polynomial j at its own point x[j], writing the results to out.
+	void ValueAt(const C* x, C* out) const
+	{
+		this->ForEachTile([&](const std::size_t begin, const std::size_t end) {
+			std::fill(out + begin, out + end, C(0));
+
+			for (auto k = this->size; k > 0; k--)
+			{
+				const auto c = this->Exponent(k - 1);
+
+				for (auto j = begin; j < end; j++)
+				{
+					out[j] = out[j] * x[j] + c[j];
+				}
+			}
+		});
+	}
+
+	//Computes the derivatives of all polynomials, as a batch with one coefficient less.
+	PolynomialBatch<C> CalculateDerivative() const
+	{
+		PolynomialBatch<C> res(this->count, this->size > 0 ? this->size - 1 : 0);
+
+		for (std::size_t k = 1; k < this->size; k++)
+		{
+			const auto c = this->Exponent(k);
+			const auto d = res.Exponent(k - 1);
+			const auto factor = static_cast<C>(k);
+
+			for (std::size_t j = 0; j < this->count; j++)
+			{
+				d[j] = c[j] * factor;
+			}
+		}
+
+		return res;
+	}
+
+	/*
+		Computes the integral of every polynomial j over [a[j], b[j]], writing the results to out.
+		The antiderivative is evaluated by Horner directly from the coefficients, without building it.
+	*/
+	void CalculateIntegral(const C* a, const C* b, C* out) const
+	{
+		static_assert(!std::is_integral<C>::value, "Integrals for integer types are not supported");
+
+		this->ForEachTile([&](const std::size_t begin, const std::size_t end) {
+			C fa[tileSize];
+			C fb[tileSize];
+			const auto n = end - begin;
+
+			std::fill(fa, fa + n, C(0));
+			std::fill(fb, fb + n, C(0));
+
+			for (auto k = this->size; k > 0; k--)
+			{
+				const auto c = this->Exponent(k - 1) + begin;
+				const auto scale = C(1) / static_cast<C>(k);
+
+				for (std::size_t j = 0; j < n; j++)
+				{
+					fa[j] = fa[j] * a[begin + j] + c[j] * scale;
+					fb[j] = fb[j] * b[begin + j] + c[j] * scale;
+				}
+			}
+
+			//The antiderivative has no constant term, so it is x times the Horner sum
+			for (std::size_t j = 0; j < n; j++)
+			{
+				out[begin + j] = fb[j] * b[begin + j] - fa[j] * a[begin + j];
+			}
+		});
+	}
+};
+
+#endif
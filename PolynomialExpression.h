@@ -0,0 +1,182 @@
+/*
+	Name: 			Michael Lausdahl Fuglsang
+	email:			mfugls11
+	Study No.:		20112699
+
+	Code also available at:
+	https://github.com/Malakahh/Ap-exam-part-2
+*/
+
+#ifndef _POLYNOMIAL_EXPRESSION
+#define _POLYNOMIAL_EXPRESSION
+
+#include <initializer_list>
+#include <algorithm>
+
+#include "Polynomial.h"
+
+/*
+	Opt-in expression templates for sums, differences and scalar scales of polynomials.
+	Building an expression does no work, Evaluate then computes every coefficient in a single pass
+	and allocates the result once, e.g.
+
+		auto r = PolynomialExpression::Evaluate(Lazy(a) + 2.0 * Lazy(b) - Lazy(c));
+
+	Polynomials are read in place, so don't alter them while an expression referring to them is alive.
+*/
+namespace PolynomialExpression
+{
+	//Base of all expression nodes, E is the node type itself
+	template <typename E> struct Expression
+	{
+		const E& Self() const { return static_cast<const E&>(*this); }
+	};
+
+	//A polynomial taking part in an expression
+	template <typename C> class Leaf : public Expression<Leaf<C>>
+	{
+	private:
+		const Polynomial<C>* polynomial;
+		const C* data;
+		std::size_t size;
+
+	public:
+		typedef C Value;
+
+		explicit Leaf(const Polynomial<C>& p) : polynomial(&p), data(p.Data()), size(p.Size()) {}
+
+		std::size_t Size() const { return this->size; }
+
+		C operator[](const std::size_t exponent) const
+		{
+			if (exponent >= this->size)
+			{
+				return C(0);
+			}
+
+			//Sparse polynomials have no buffer, and are read one coefficient at a time
+			return this->data != nullptr ? this->data[exponent] : this->polynomial->GetCoefficient(exponent);
+		}
+	};
+
+	template <typename L, typename R> class Sum : public Expression<Sum<L, R>>
+	{
+	private:
+		L lhs;
+		R rhs;
+
+	public:
+		typedef typename L::Value Value;
+
+		Sum(const L& lhs, const R& rhs) : lhs(lhs), rhs(rhs) {}
+
+		std::size_t Size() const { return std::max(this->lhs.Size(), this->rhs.Size()); }
+
+		Value operator[](const std::size_t exponent) const { return this->lhs[exponent] + this->rhs[exponent]; }
+	};
+
+	template <typename L, typename R> class Difference : public Expression<Difference<L, R>>
+	{
+	private:
+		L lhs;
+		R rhs;
+
+	public:
+		typedef typename L::Value Value;
+
+		Difference(const L& lhs, const R& rhs) : lhs(lhs), rhs(rhs) {}
+
+		std::size_t Size() const { return std::max(this->lhs.Size(), this->rhs.Size()); }
+
+		Value operator[](const std::size_t exponent) const { return this->lhs[exponent] - this->rhs[exponent]; }
+	};
+
+	template <typename E> class Scaled : public Expression<Scaled<E>>
+	{
+	private:
+		E expression;
+		typename E::Value scalar;
+
+	public:
+		typedef typename E::Value Value;
+
+		Scaled(const E& expression, const Value scalar) : expression(expression), scalar(scalar) {}
+
+		std::size_t Size() const { return this->expression.Size(); }
+
+		Value operator[](const std::size_t exponent) const { return this->scalar * this->expression[exponent]; }
+	};
+
+	//Makes a polynomial usable in expressions.
+	template <typename C> Leaf<C> Lazy(const Polynomial<C>& p)
+	{
+		return Leaf<C>(p);
+	}
+
+	template <typename L, typename R> Sum<L, R> operator+(const Expression<L>& lhs, const Expression<R>& rhs)
+	{
+		return Sum<L, R>(lhs.Self(), rhs.Self());
+	}
+
+	template <typename E> Sum<E, Leaf<typename E::Value>> operator+(const Expression<E>& lhs, const Polynomial<typename E::Value>& rhs)
+	{
+		return Sum<E, Leaf<typename E::Value>>(lhs.Self(), Leaf<typename E::Value>(rhs));
+	}
+
+	template <typename E> Sum<Leaf<typename E::Value>, E> operator+(const Polynomial<typename E::Value>& lhs, const Expression<E>& rhs)
+	{
+		return Sum<Leaf<typename E::Value>, E>(Leaf<typename E::Value>(lhs), rhs.Self());
+	}
+
+	template <typename L, typename R> Difference<L, R> operator-(const Expression<L>& lhs, const Expression<R>& rhs)
+	{
+		return Difference<L, R>(lhs.Self(), rhs.Self());
+	}
+
+	template <typename E> Difference<E, Leaf<typename E::Value>> operator-(const Expression<E>& lhs, const Polynomial<typename E::Value>& rhs)
+	{
+		return Difference<E, Leaf<typename E::Value>>(lhs.Self(), Leaf<typename E::Value>(rhs));
+	}
+
+	template <typename E> Difference<Leaf<typename E::Value>, E> operator-(const Polynomial<typename E::Value>& lhs, const Expression<E>& rhs)
+	{
+		return Difference<Leaf<typename E::Value>, E>(Leaf<typename E::Value>(lhs), rhs.Self());
+	}
+
+	template <typename E> Scaled<E> operator*(const typename E::Value scalar, const Expression<E>& e)
+	{
+		return Scaled<E>(e.Self(), scalar);
+	}
+
+	template <typename E> Scaled<E> operator*(const Expression<E>& e, const typename E::Value scalar)
+	{
+		return Scaled<E>(e.Self(), scalar);
+	}
+
+	//Computes the coefficients of an expression into a new polynomial.
+	template <typename E> Polynomial<typename E::Value> Evaluate(const Expression<E>& expression)
+	{
+		typedef typename E::Value C;
+
+		const auto& e = expression.Self();
+		const auto size = e.Size();
+
+		//Start out without coefficients, so the result buffer is allocated exactly once
+		Polynomial<C> result(std::initializer_list<C>{});
+
+		{
+			auto m = result.Mutate();
+			m.Resize(size);
+
+			auto out = m.Data();
+			for (std::size_t i = 0; i < size; i++)
+			{
+				out[i] = e[i];
+			}
+		}
+
+		return result;
+	}
+}
+
+#endif
@@ -0,0 +1,441 @@
+/*
+	Name: 			Michael Lausdahl Fuglsang
+	email:			mfugls11
+	Study No.:		20112699
+
+	Code also available at:
+	https://github.com/Malakahh/Ap-exam-part-2
+*/
+
+#ifndef _POLYNOMIAL_FORMAT
+#define _POLYNOMIAL_FORMAT
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cerrno>
+#include <cmath>
+#include <limits>
+#include <vector>
+#include <algorithm>
+#include <type_traits>
+
+#include "Polynomial.h"
+#include "ModInt.h"
+
+/*
+	Text formatting and parsing of polynomials into and out of caller buffers, in the
+	"P(x) = 3x^4 + -2x^2 + 0x + 1" form of operator<<, without iostreams.
+
+	Modelled on std::to_chars and std::from_chars, which aren't available in C++14. Integers are
+	formatted and parsed by hand. Floating point coefficients go through snprintf and strtod, which
+	use the "C" locale unless the program calls setlocale.
+*/
+struct FormatOptions
+{
+	//Leave out terms with a zero coefficient. A polynomial with only zeros is written as "0".
+	bool skipZeros = false;
+
+	//Significant digits for floating point coefficients, 0 for enough digits to read back the exact value.
+	int precision = 6;
+
+	//Start with "P(x) = ".
+	bool prefix = true;
+};
+
+//Result of FormatPolynomial: one past the last character written, or last and ok false if the buffer was too small.
+struct FormatResult
+{
+	char* ptr;
+	bool ok;
+};
+
+//Result of ParsePolynomial: one past the last character parsed, or first and ok false if no polynomial was found.
+struct ParseResult
+{
+	const char* ptr;
+	bool ok;
+};
+
+namespace PolynomialFormat
+{
+	//Appends text to [p, last), returning false if it doesn't fit
+	inline bool Write(char*& p, char* const last, const char* text, const std::size_t length)
+	{
+		if (static_cast<std::size_t>(last - p) < length)
+		{
+			return false;
+		}
+
+		std::memcpy(p, text, length);
+		p += length;
+
+		return true;
+	}
+
+	inline bool WriteUnsigned(char*& p, char* const last, unsigned long long value)
+	{
+		char digits[24];
+		auto d = digits + sizeof(digits);
+
+		do
+		{
+			*--d = static_cast<char>('0' + value % 10);
+			value /= 10;
+		} while (value != 0);
+
+		return Write(p, last, d, digits + sizeof(digits) - d);
+	}
+
+	template <typename C> bool WriteCoefficient(char*& p, char* const last, const C value, const int, std::true_type)
+	{
+		if (value < 0)
+		{
+			if (!Write(p, last, "-", 1))
+			{
+				return false;
+			}
+
+			return WriteUnsigned(p, last, 0ull - static_cast<unsigned long long>(static_cast<long long>(value)));
+		}
+
+		return WriteUnsigned(p, last, static_cast<unsigned long long>(value));
+	}
+
+	inline int FormatFloating(char* buffer, const std::size_t size, const double value, const int precision)
+	{
+		return std::snprintf(buffer, size, "%.*g", precision, value);
+	}
+
+	inline int FormatFloating(char* buffer, const std::size_t size, const long double value, const int precision)
+	{
+		return std::snprintf(buffer, size, "%.*Lg", precision, value);
+	}
+
+	template <typename C> bool WriteCoefficient(char*& p, char* const last, const C value, const int precision, std::false_type)
+	{
+		typedef typename std::conditional<std::is_same<C, long double>::value, long double, double>::type Wide;
+
+		char buffer[64];
+		const auto digits = precision > 0 ? precision : std::numeric_limits<C>::max_digits10;
+		const auto length = FormatFloating(buffer, sizeof(buffer), static_cast<Wide>(value), std::min(digits, 40));
+
+		return length > 0 && Write(p, last, buffer, static_cast<std::size_t>(length));
+	}
+
+	//Modular coefficients are written as their representative in [0, P)
+	template <std::uint32_t P> bool WriteCoefficient(char*& p, char* const last, const ModInt<P> value, const int, std::false_type)
+	{
+		return WriteUnsigned(p, last, value.Value());
+	}
+
+	inline const char* SkipSpace(const char* p, const char* last)
+	{
+		while (p != last && (*p == ' ' || *p == '\t'))
+		{
+			p++;
+		}
+
+		return p;
+	}
+
+	inline bool IsDigit(const char c)
+	{
+		return c >= '0' && c <= '9';
+	}
+
+	//Parses the digits at p, returning nullptr if there are none. Sets outOfRange if they don't fit value
+	inline const char* ParseUnsigned(const char* p, const char* last, unsigned long long& value, bool& outOfRange)
+	{
+		value = 0;
+		const auto start = p;
+
+		while (p != last && IsDigit(*p))
+		{
+			const auto digit = static_cast<unsigned long long>(*p - '0');
+
+			if (value > (std::numeric_limits<unsigned long long>::max() - digit) / 10)
+			{
+				outOfRange = true;
+			}
+
+			value = value * 10 + digit;
+			p++;
+		}
+
+		return p == start ? nullptr : p;
+	}
+
+	/*
+		Parses the digits of a coefficient, with the sign already read, returning nullptr if there is none.
+		Sets outOfRange if it doesn't fit C. The sign is applied here, so negative integers reach min().
+	*/
+	template <typename C> const char* ParseCoefficient(const char* p, const char* last, const bool negative, C& value, bool& outOfRange, std::true_type)
+	{
+		unsigned long long magnitude;
+		p = ParseUnsigned(p, last, magnitude, outOfRange);
+
+		//-min() is one more than max()
+		const auto largest = static_cast<unsigned long long>(std::numeric_limits<C>::max());
+		if (magnitude > largest + (negative ? 1 : 0))
+		{
+			outOfRange = true;
+			value = C(0);
+		}
+		else
+		{
+			value = negative && magnitude > 0 ? static_cast<C>(-static_cast<C>(magnitude - 1) - 1) : static_cast<C>(magnitude);
+		}
+
+		return p;
+	}
+
+	template <std::uint32_t P> const char* ParseCoefficient(const char* p, const char* last, const bool negative, ModInt<P>& value, bool& outOfRange, std::false_type)
+	{
+		unsigned long long magnitude;
+		p = ParseUnsigned(p, last, magnitude, outOfRange);
+		value = static_cast<long long>(magnitude % P);
+
+		if (negative)
+		{
+			value = -value;
+		}
+
+		return p;
+	}
+
+	inline void ParseFloating(const char* text, char** end, float& value) { value = std::strtof(text, end); }
+	inline void ParseFloating(const char* text, char** end, double& value) { value = std::strtod(text, end); }
+	inline void ParseFloating(const char* text, char** end, long double& value) { value = std::strtold(text, end); }
+
+	template <typename C> const char* ParseCoefficient(const char* p, const char* last, const bool negative, C& value, bool& outOfRange, std::false_type)
+	{
+		//Copy the token, as strtod needs a terminated string and must not read past last
+		char token[80];
+		std::size_t length = 0;
+
+		while (p + length != last && length + 1 < sizeof(token))
+		{
+			const auto c = p[length];
+			const auto exponentSign = (c == '+' || c == '-') && length > 0 && (p[length - 1] == 'e' || p[length - 1] == 'E');
+
+			if (!IsDigit(c) && c != '.' && c != 'e' && c != 'E' && !exponentSign
+				&& !(c >= 'a' && c <= 'z' && c != 'x') && !(c >= 'A' && c <= 'Z'))
+			{
+				break;
+			}
+
+			token[length] = c;
+			length++;
+		}
+
+		token[length] = '\0';
+
+		char* end;
+		errno = 0;
+		ParseFloating(token, &end, value);
+
+		//Underflow rounds towards zero, and only overflow is out of range
+		if (errno == ERANGE && std::isinf(value))
+		{
+			outOfRange = true;
+		}
+
+		if (negative)
+		{
+			value = -value;
+		}
+
+		return end == token ? nullptr : p + (end - token);
+	}
+
+	/*
+		Parses a term: [coefficient]['x'['^' exponent]], with at least one of the parts.
+		negative is the sign of a preceding '-' separator, combined with the sign of the term itself.
+		Sets outOfRange if the coefficient doesn't fit C or the exponent doesn't fit unsigned int.
+	*/
+	template <typename C> const char* ParseTerm(const char* p, const char* last, bool negative, C& value, std::size_t& exponent, bool& outOfRange)
+	{
+		if (p != last && (*p == '-' || *p == '+'))
+		{
+			negative = negative != (*p == '-');
+			p = SkipSpace(p + 1, last);
+		}
+
+		typename std::is_integral<C>::type isIntegral;
+		auto end = p != last && *p != 'x' ? ParseCoefficient(p, last, negative, value, outOfRange, isIntegral) : nullptr;
+
+		if (end == nullptr)
+		{
+			if (p == last || *p != 'x')
+			{
+				return nullptr;
+			}
+
+			value = negative ? C(-1) : C(1);
+			end = p;
+		}
+
+		exponent = 0;
+
+		if (end != last && *end == 'x')
+		{
+			end++;
+			exponent = 1;
+
+			unsigned long long e;
+			const char* afterExponent;
+			if (end != last && *end == '^' && (afterExponent = ParseUnsigned(end + 1, last, e, outOfRange)) != nullptr)
+			{
+				if (e > std::numeric_limits<unsigned int>::max())
+				{
+					outOfRange = true;
+				}
+
+
+				exponent = static_cast<std::size_t>(e);
+				end = afterExponent;
+			}
+		}
+
+		return end;
+	}
+}
+
+/*
+	Writes a polynomial to [first, last), highest exponent first, without a terminating zero.
+*/
+template <typename C> FormatResult FormatPolynomial(char* first, char* last, const Polynomial<C>& p, const FormatOptions& options = FormatOptions())
+{
+	using namespace PolynomialFormat;
+
+	typename std::is_integral<C>::type isIntegral;
+	auto out = first;
+	auto written = false;
+
+	if (options.prefix && !Write(out, last, "P(x) = ", 7))
+	{
+		return { last, false };
+	}
+
+	const auto data = p.Data();
+
+	for (auto i = p.Size(); i-- > 0;)
+	{
+		const auto c = data != nullptr ? data[i] : p.GetCoefficient(static_cast<unsigned int>(i));
+
+		if (options.skipZeros && c == C(0) && (i > 0 || written))
+		{
+			continue;
+		}
+
+		if ((written && !Write(out, last, " + ", 3)) || !WriteCoefficient(out, last, c, options.precision, isIntegral))
+		{
+			return { last, false };
+		}
+
+		if (i > 0 && (!Write(out, last, "x", 1) || (i > 1 && (!Write(out, last, "^", 1) || !WriteUnsigned(out, last, i)))))
+		{
+			return { last, false };
+		}
+
+		written = true;
+	}
+
+	return { out, true };
+}
+
+/*
+	Parses a polynomial from [first, last) into p, replacing its coefficients.
+	Reads the output of FormatPolynomial and operator<<, and more generally sums and differences of
+	terms like 3x^4, -2.5x, x^2 and 7 in any order, with an optional "P(x) =" in front.
+	Terms with the same exponent are added. Parsing stops at the first character that doesn't continue the polynomial.
+	Like std::from_chars, a coefficient that doesn't fit C or an exponent that doesn't fit unsigned int fails
+	the whole parse, returning first and ok false, and p is left unchanged.
+*/
+template <typename C> ParseResult ParsePolynomial(const char* first, const char* last, Polynomial<C>& p)
+{
+	using namespace PolynomialFormat;
+
+	auto position = SkipSpace(first, last);
+
+	if (last - position >= 4 && std::memcmp(position, "P(x)", 4) == 0)
+	{
+		position = SkipSpace(position + 4, last);
+
+		if (position == last || *position != '=')
+		{
+			return { first, false };
+		}
+
+		position = SkipSpace(position + 1, last);
+	}
+
+	struct ParsedTerm
+	{
+		std::size_t exponent;
+		C value;
+	};
+
+	auto terms = std::vector<ParsedTerm>();
+
+	C value;
+	std::size_t exponent;
+	auto outOfRange = false;
+	auto end = ParseTerm(position, last, false, value, exponent, outOfRange);
+
+	if (end == nullptr || outOfRange)
+	{
+		return { first, false };
+	}
+
+	terms.push_back({ exponent, value });
+	position = end;
+
+	//Further terms follow a + or -
+	while (true)
+	{
+		auto separator = SkipSpace(position, last);
+
+		if (separator == last || (*separator != '+' && *separator != '-'))
+		{
+			break;
+		}
+
+		end = ParseTerm(SkipSpace(separator + 1, last), last, *separator == '-', value, exponent, outOfRange);
+
+		if (outOfRange)
+		{
+			return { first, false };
+		}
+
+		if (end == nullptr)
+		{
+			break;
+		}
+
+		terms.push_back({ exponent, value });
+		position = end;
+	}
+
+	std::stable_sort(terms.begin(), terms.end(), [](const ParsedTerm& a, const ParsedTerm& b) { return a.exponent < b.exponent; });
+
+	Polynomial<C> result(std::initializer_list<C>{});
+	for (std::size_t i = 0; i < terms.size(); i++)
+	{
+		auto sum = terms[i].value;
+
+		while (i + 1 < terms.size() && terms[i + 1].exponent == terms[i].exponent)
+		{
+			sum += terms[++i].value;
+		}
+
+		result.SetCoefficient(sum, static_cast<unsigned int>(terms[i].exponent));
+	}
+
+	p = std::move(result);
+
+	return { position, true };
+}
+
+#endif
@@ -0,0 +1,2595 @@
+/*
+	Name: 			Michael Lausdahl Fuglsang
+	email:			mfugls11
+	Study No.:		20112699
+
+	Code also available at:
+	https://github.com/Malakahh/Ap-exam-part-2
+*/
+
+#ifndef _POLYNOMIAL_KERNELS
+#define _POLYNOMIAL_KERNELS
+
+#include <cstddef>
+#include <vector>
+#include <complex>
+#include <cmath>
+#include <algorithm>
+#include <type_traits>
+#include <limits>
+#include <atomic>
+#include <cstdint>
+#include <stdexcept>
+
+#include "Executor.h"
+#include "PolynomialStats.h"
+#include "ModInt.h"
+
+/*
+	SIMD kernels for float and double. Builds targeting AVX-512 use them directly. Otherwise GCC on x86 compiles
+	AVX2 and FMA versions through the target pragma, which run when the processor supports them.
+*/
+#if defined(__AVX512F__)
+#define POLYNOMIAL_SIMD_AVX512
+#elif defined(__GNUC__) && !defined(__clang__) && (defined(__x86_64__) || defined(__i386__))
+#define POLYNOMIAL_SIMD_AVX2_DISPATCH
+#endif
+
+#if defined(POLYNOMIAL_SIMD_AVX512) || defined(POLYNOMIAL_SIMD_AVX2_DISPATCH)
+#include <immintrin.h>
+#endif
+
+/*
+	Computational kernels used internally by Polynomial.
+	They work directly on a contiguous coefficient buffer, ordered lowest exponent first,
+	so the hot loops avoid the bounds checked accessors.
+*/
+namespace PolynomialKernels
+{
+	//Number of coefficients from which single point evaluation uses Estrin instead of Horner
+	const std::size_t estrinThreshold = 32;
+
+	//Amount of work, in multiply-adds, from which a kernel splits its work across the executor
+	const std::size_t parallelWorkThreshold = 1 << 16;
+
+	//Horner evaluation of a single point
+	template <typename C> C Horner(const C* coefficients, const std::size_t count, const C x)
+	{
+		C res = 0;
+
+		for (auto i = count; i > 0; i--)
+		{
+			res = res * x + coefficients[i - 1];
+		}
+
+		return res;
+	}
+
+	/*
+		Estrin evaluation of a single point.
+		Blocks of 8 terms are evaluated independently of each other and then combined using Horner in x^8,
+		which shortens the dependency chain for high degrees.
+	*/
+	template <typename C> C Estrin(const C* coefficients, const std::size_t count, const C x)
+	{
+		const C x2 = x * x;
+		const C x4 = x2 * x2;
+		const C x8 = x4 * x4;
+
+		//The highest, possibly partial, block
+		auto blocks = count / 8;
+		C res = Horner(coefficients + blocks * 8, count % 8, x);
+
+		for (auto b = blocks; b > 0; b--)
+		{
+			auto c = coefficients + (b - 1) * 8;
+
+			C block = (c[0] + c[1] * x) + (c[2] + c[3] * x) * x2
+				+ ((c[4] + c[5] * x) + (c[6] + c[7] * x) * x2) * x4;
+
+			res = res * x8 + block;
+		}
+
+		return res;
+	}
+
+	//Evaluates a single point, choosing the scheme by degree
+	template <typename C> C Evaluate(const C* coefficients, const std::size_t count, const C x)
+	{
+		if (count >= estrinThreshold)
+		{
+			return Estrin(coefficients, count, x);
+		}
+
+		return Horner(coefficients, count, x);
+	}
+
+	/*
+		Evaluates n points at once.
+		Generic version, used for long double and integer types, and on processors without AVX2. Horner is run on 8 points at a time,
+		which gives independent accumulators the compiler is free to vectorize.
+	*/
+	template <typename C> void EvaluateBatch(const C* coefficients, const std::size_t count, const C* x, C* out, const std::size_t n)
+	{
+		const std::size_t lanes = 8;
+		std::size_t j = 0;
+
+		for (; j + lanes <= n; j += lanes)
+		{
+			C acc[lanes] = {};
+
+			for (auto i = count; i > 0; i--)
+			{
+				const C c = coefficients[i - 1];
+
+				for (std::size_t l = 0; l < lanes; l++)
+				{
+					acc[l] = acc[l] * x[j + l] + c;
+				}
+			}
+
+			for (std::size_t l = 0; l < lanes; l++)
+			{
+				out[j + l] = acc[l];
+			}
+		}
+
+		//Remaining points
+		for (; j < n; j++)
+		{
+			out[j] = Horner(coefficients, count, x[j]);
+		}
+	}
+
+	/*
+		Schoolbook multiplication, O(n*m).
+		Writes all n + m - 1 coefficients of the product to out.
+	*/
+	template <typename C> void MultiplySchoolbook(const C* a, const std::size_t n, const C* b, const std::size_t m, C* out)
+	{
+		std::fill(out, out + n + m - 1, C(0));
+
+		for (std::size_t i = 0; i < n; i++)
+		{
+			const C ai = a[i];
+
+			for (std::size_t j = 0; j < m; j++)
+			{
+				out[i + j] += ai * b[j];
+			}
+		}
+	}
+
+	//Output coefficients per tile of the blocked schoolbook multiplication, small enough to stay in the L1 cache
+	const std::size_t schoolbookTileSize = 1024;
+
+	/*
+		Schoolbook multiplication in tiles of the output, split across the executor for large products.
+		Each tile accumulates the products of the blocks of a and b that land in it while it stays in cache,
+		and no two tiles write the same coefficient.
+	*/
+	template <typename C> void MultiplySchoolbookTiled(const C* a, const std::size_t n, const C* b, const std::size_t m, C* out, Executor& executor)
+	{
+		const auto size = n + m - 1;
+
+		if (n * m < parallelWorkThreshold || size <= schoolbookTileSize || executor.Concurrency() <= 1)
+		{
+			MultiplySchoolbook(a, n, b, m, out);
+			return;
+		}
+
+		const auto tiles = (size + schoolbookTileSize - 1) / schoolbookTileSize;
+		const auto grain = std::max<std::size_t>(1, parallelWorkThreshold / (schoolbookTileSize * m));
+
+		ParallelFor(executor, tiles, grain, [&](const std::size_t begin, const std::size_t end) {
+			for (auto t = begin; t < end; t++)
+			{
+				const auto first = t * schoolbookTileSize;
+				const auto last = std::min(size, first + schoolbookTileSize);
+
+				std::fill(out + first, out + last, C(0));
+
+				//out[k] = sum of a[i] * b[k - i], for the i reaching [first, last)
+				const auto iFirst = first >= m - 1 ? first - (m - 1) : 0;
+				const auto iLast = std::min(n, last);
+
+				for (auto i = iFirst; i < iLast; i++)
+				{
+					const C ai = a[i];
+					const auto jFirst = first > i ? first - i : 0;
+					const auto jLast = std::min(m, last - i);
+
+					for (auto j = jFirst; j < jLast; j++)
+					{
+						out[i + j] += ai * b[j];
+					}
+				}
+			}
+		});
+	}
+
+	/*
+		Karatsuba multiplication of two operands of equal length n, O(n^1.58).
+		Writes 2n - 1 coefficients to out. Scratch must hold at least 8n coefficients.
+	*/
+	template <typename C> void KaratsubaSquare(const C* a, const C* b, const std::size_t n, C* out, C* scratch, const std::size_t threshold)
+	{
+		if (n < threshold || n < 2)
+		{
+			MultiplySchoolbook(a, n, b, n, out);
+			return;
+		}
+
+		//Split into a low half of h terms and a high half of k terms
+		const auto h = n / 2;
+		const auto k = n - h;
+
+		//z0 = a0 * b0 goes to the bottom and z2 = a1 * b1 to the top of out
+		KaratsubaSquare(a, b, h, out, scratch, threshold);
+		out[2 * h - 1] = 0;
+		KaratsubaSquare(a + h, b + h, k, out + 2 * h, scratch, threshold);
+
+		//z1 = (a0 + a1) * (b0 + b1) - z0 - z2
+		auto sa = scratch;
+		auto sb = scratch + k;
+		auto z1 = scratch + 2 * k;
+
+		for (std::size_t i = 0; i < k; i++)
+		{
+			sa[i] = a[h + i] + (i < h ? a[i] : C(0));
+			sb[i] = b[h + i] + (i < h ? b[i] : C(0));
+		}
+
+		KaratsubaSquare(sa, sb, k, z1, scratch + 4 * k, threshold);
+
+		for (std::size_t i = 0; i < 2 * h - 1; i++)
+		{
+			z1[i] -= out[i];
+		}
+
+		for (std::size_t i = 0; i < 2 * k - 1; i++)
+		{
+			z1[i] -= out[2 * h + i];
+		}
+
+		for (std::size_t i = 0; i < 2 * k - 1; i++)
+		{
+			out[h + i] += z1[i];
+		}
+	}
+
+	/*
+		Karatsuba multiplication of two operands of equal length n, see KaratsubaSquare.
+		The three sub-products of the top levels run as separate tasks on the executor, each with its own scratch space.
+	*/
+	template <typename C> void KaratsubaSquareParallel(const C* a, const C* b, const std::size_t n, C* out, const std::size_t threshold, Executor& executor)
+	{
+		//Parallelizing is only worth it while the sub-products are large
+		if (n < threshold || n < 2 || n * n < 4 * parallelWorkThreshold || executor.Concurrency() <= 1)
+		{
+			auto scratch = std::vector<C>(8 * n + 8);
+			KaratsubaSquare(a, b, n, out, scratch.data(), threshold);
+			return;
+		}
+
+		const auto h = n / 2;
+		const auto k = n - h;
+
+		auto sa = std::vector<C>(k);
+		auto sb = std::vector<C>(k);
+		auto z1 = std::vector<C>(2 * k - 1);
+
+		for (std::size_t i = 0; i < k; i++)
+		{
+			sa[i] = a[h + i] + (i < h ? a[i] : C(0));
+			sb[i] = b[h + i] + (i < h ? b[i] : C(0));
+		}
+
+		TaskGroup group(executor);
+		group.Run([=, &executor]() { KaratsubaSquareParallel(a, b, h, out, threshold, executor); });
+		group.Run([=, &executor]() { KaratsubaSquareParallel(a + h, b + h, k, out + 2 * h, threshold, executor); });
+		KaratsubaSquareParallel(sa.data(), sb.data(), k, z1.data(), threshold, executor);
+		group.Wait();
+
+		out[2 * h - 1] = 0;
+
+		for (std::size_t i = 0; i < 2 * h - 1; i++)
+		{
+			z1[i] -= out[i];
+		}
+
+		for (std::size_t i = 0; i < 2 * k - 1; i++)
+		{
+			z1[i] -= out[2 * h + i];
+			out[h + i] += z1[i];
+		}
+	}
+
+	/*
+		Karatsuba multiplication of operands of any length, n >= m.
+		The longer operand is cut into chunks the size of the shorter one.
+	*/
+	template <typename C> void MultiplyKaratsuba(const C* a, const std::size_t n, const C* b, const std::size_t m, C* out, const std::size_t threshold, Executor& executor)
+	{
+		std::fill(out, out + n + m - 1, C(0));
+
+		auto chunk = std::vector<C>(2 * m - 1);
+
+		for (std::size_t s = 0; s < n; s += m)
+		{
+			const auto length = std::min(m, n - s);
+
+			if (length == m)
+			{
+				KaratsubaSquareParallel(a + s, b, m, chunk.data(), threshold, executor);
+			}
+			else
+			{
+				MultiplyKaratsuba(b, m, a + s, length, chunk.data(), threshold, executor);
+			}
+
+			for (std::size_t i = 0; i < length + m - 1; i++)
+			{
+				out[s + i] += chunk[i];
+			}
+		}
+	}
+
+	//Scalar type used for the FFT of a coefficient type
+	template <typename C> struct FftScalar { typedef double Type; };
+	template <> struct FftScalar<long double> { typedef long double Type; };
+
+	//Complex multiplication without the NaN/Inf recovery of std::complex
+	template <typename F> std::complex<F> ComplexMultiply(const std::complex<F>& a, const std::complex<F>& b)
+	{
+		return std::complex<F>(a.real() * b.real() - a.imag() * b.imag(), a.real() * b.imag() + a.imag() * b.real());
+	}
+
+	//Reverses the lowest bits of index, for a transform of the given power of two size
+	inline std::size_t ReverseBits(std::size_t index, const std::size_t size)
+	{
+		std::size_t res = 0;
+
+		for (auto bit = size >> 1; bit > 0; bit >>= 1, index >>= 1)
+		{
+			res = (res << 1) | (index & 1);
+		}
+
+		return res;
+	}
+
+	//Butterflies per task when a transform is split across the executor
+	const std::size_t fftGrain = parallelWorkThreshold / 4;
+
+	/*
+		Iterative radix-2 FFT, in place. The size of data must be a power of two,
+		and roots must hold exp(2*pi*i*j/size) for j < size/2.
+		The permutation and the butterflies of each stage are split across the executor for large transforms.
+	*/
+	template <typename F> void Fft(std::vector<std::complex<F>>& data, const std::vector<std::complex<F>>& roots, const bool inverse, Executor& executor)
+	{
+		const auto size = data.size();
+
+		//Bit reversal permutation, every pair swapped by its lower index
+		ParallelFor(executor, size, fftGrain, [&](const std::size_t begin, const std::size_t end) {
+			auto j = ReverseBits(begin, size);
+
+			for (auto i = begin; i < end; i++)
+			{
+				if (i < j)
+				{
+					std::swap(data[i], data[j]);
+				}
+
+				//Advance j to the bit reversal of i + 1
+				auto bit = size >> 1;
+				for (; j & bit; bit >>= 1)
+				{
+					j ^= bit;
+				}
+				j ^= bit;
+			}
+		});
+
+		//Butterflies, numbered through all blocks of a stage so every stage splits evenly
+		for (std::size_t length = 2; length <= size; length <<= 1)
+		{
+			const auto half = length / 2;
+			const auto stride = size / length;
+
+			ParallelFor(executor, size / 2, fftGrain, [&](const std::size_t begin, const std::size_t end) {
+				auto i = begin / half * length;
+				auto k = begin % half;
+
+				for (auto t = begin; t < end; t++)
+				{
+					auto w = roots[k * stride];
+					if (inverse)
+					{
+						w = std::conj(w);
+					}
+
+					auto u = data[i + k];
+					auto v = ComplexMultiply(data[i + k + half], w);
+
+					data[i + k] = u + v;
+					data[i + k + half] = u - v;
+
+					if (++k == half)
+					{
+						k = 0;
+						i += length;
+					}
+				}
+			});
+		}
+	}
+
+	//Computes the roots of unity used by Fft for a transform of the given size
+	template <typename F> std::vector<std::complex<F>> FftRoots(const std::size_t size)
+	{
+		const F pi = std::acos(F(-1));
+		auto roots = std::vector<std::complex<F>>(size / 2);
+
+		for (std::size_t j = 0; j < roots.size(); j++)
+		{
+			const F angle = 2 * pi * j / size;
+			roots[j] = std::complex<F>(std::cos(angle), std::sin(angle));
+		}
+
+		return roots;
+	}
+
+	/*
+		FFT based multiplication, O((n + m) log(n + m)).
+		a is packed into the real part and b into the imaginary part, so squaring the transform
+		gives a*a - b*b + 2i(a*b), and the product is half the imaginary part of its inverse.
+	*/
+	template <typename C> void MultiplyFft(const C* a, const std::size_t n, const C* b, const std::size_t m, C* out, Executor& executor)
+	{
+		typedef typename FftScalar<C>::Type F;
+
+		const auto resultSize = n + m - 1;
+		std::size_t size = 1;
+		while (size < resultSize)
+		{
+			size <<= 1;
+		}
+
+		auto data = std::vector<std::complex<F>>(size);
+		ParallelFor(executor, size, fftGrain, [&](const std::size_t begin, const std::size_t end) {
+			for (auto i = begin; i < end; i++)
+			{
+				data[i] = std::complex<F>(i < n ? F(a[i]) : F(0), i < m ? F(b[i]) : F(0));
+			}
+		});
+
+		auto roots = FftRoots<F>(size);
+
+		Fft(data, roots, false, executor);
+
+		ParallelFor(executor, size, fftGrain, [&](const std::size_t begin, const std::size_t end) {
+			for (auto i = begin; i < end; i++)
+			{
+				data[i] = ComplexMultiply(data[i], data[i]);
+			}
+		});
+
+		Fft(data, roots, true, executor);
+
+		for (std::size_t i = 0; i < resultSize; i++)
+		{
+			out[i] = static_cast<C>(data[i].imag() / (2 * F(size)));
+		}
+	}
+
+	//Number of factors of two in P - 1, which bounds the size of a number theoretic transform modulo P
+	inline std::size_t TwoAdicity(const std::uint32_t p)
+	{
+		std::size_t res = 0;
+
+		for (auto q = p - 1; q % 2 == 0; q /= 2)
+		{
+			res++;
+		}
+
+		return res;
+	}
+
+	/*
+		Smallest generator of the multiplicative group modulo the prime P, found by factoring P - 1.
+		Computed once per modulus.
+	*/
+	template <std::uint32_t P> ModInt<P> PrimitiveRoot()
+	{
+		static const ModInt<P> root = []() {
+			auto factors = std::vector<std::uint32_t>();
+			auto rest = P - 1;
+
+			for (std::uint32_t f = 2; f * f <= rest; f++)
+			{
+				if (rest % f == 0)
+				{
+					factors.push_back(f);
+
+					while (rest % f == 0)
+					{
+						rest /= f;
+					}
+				}
+			}
+
+			if (rest > 1)
+			{
+				factors.push_back(rest);
+			}
+
+			for (std::uint32_t g = 2;; g++)
+			{
+				auto generator = true;
+
+				for (auto f : factors)
+				{
+					generator = generator && ModInt<P>(g).Pow((P - 1) / f) != ModInt<P>(1);
+				}
+
+				if (generator)
+				{
+					return ModInt<P>(g);
+				}
+			}
+		}();
+
+		return root;
+	}
+
+	/*
+		Number theoretic transform modulo the prime P, in place, the exact analogue of Fft.
+		The size of data must be a power of two dividing P - 1. Split across the executor like Fft.
+	*/
+	template <std::uint32_t P> void Ntt(std::vector<ModInt<P>>& data, const bool inverse, Executor& executor)
+	{
+		const auto size = data.size();
+
+		auto root = PrimitiveRoot<P>().Pow((P - 1) / size);
+		if (inverse)
+		{
+			root = root.Inverse();
+		}
+
+		auto roots = std::vector<ModInt<P>>(std::max<std::size_t>(size / 2, 1));
+		roots[0] = 1;
+		for (std::size_t j = 1; j < roots.size(); j++)
+		{
+			roots[j] = roots[j - 1] * root;
+		}
+
+		ParallelFor(executor, size, fftGrain, [&](const std::size_t begin, const std::size_t end) {
+			auto j = ReverseBits(begin, size);
+
+			for (auto i = begin; i < end; i++)
+			{
+				if (i < j)
+				{
+					std::swap(data[i], data[j]);
+				}
+
+				auto bit = size >> 1;
+				for (; j & bit; bit >>= 1)
+				{
+					j ^= bit;
+				}
+				j ^= bit;
+			}
+		});
+
+		for (std::size_t length = 2; length <= size; length <<= 1)
+		{
+			const auto half = length / 2;
+			const auto stride = size / length;
+
+			ParallelFor(executor, size / 2, fftGrain, [&](const std::size_t begin, const std::size_t end) {
+				auto i = begin / half * length;
+				auto k = begin % half;
+
+				for (auto t = begin; t < end; t++)
+				{
+					const auto u = data[i + k];
+					const auto v = data[i + k + half] * roots[k * stride];
+
+					data[i + k] = u + v;
+					data[i + k + half] = u - v;
+
+					if (++k == half)
+					{
+						k = 0;
+						i += length;
+					}
+				}
+			});
+		}
+
+		if (inverse)
+		{
+			const auto scale = ModInt<P>(static_cast<long long>(size)).Inverse();
+
+			for (auto& d : data)
+			{
+				d *= scale;
+			}
+		}
+	}
+
+	//Integer representative of a coefficient, reduced modulo the transform primes by ModInt
+	template <std::uint32_t P> long long Representative(const ModInt<P> x) { return x.Value(); }
+	template <typename C> long long Representative(const C x) { return static_cast<long long>(x); }
+
+	//Cyclic convolution of the representatives of a and b modulo the prime Q, through a transform of the given size
+	template <std::uint32_t Q, typename C> std::vector<ModInt<Q>> ConvolveModulo(const C* a, const std::size_t n,
+		const C* b, const std::size_t m, const std::size_t size, Executor& executor)
+	{
+		auto fa = std::vector<ModInt<Q>>(size);
+		auto fb = std::vector<ModInt<Q>>(size);
+
+		for (std::size_t i = 0; i < n; i++)
+		{
+			fa[i] = Representative(a[i]);
+		}
+
+		for (std::size_t i = 0; i < m; i++)
+		{
+			fb[i] = Representative(b[i]);
+		}
+
+		Ntt(fa, false, executor);
+		Ntt(fb, false, executor);
+
+		for (std::size_t i = 0; i < size; i++)
+		{
+			fa[i] *= fb[i];
+		}
+
+		Ntt(fa, true, executor);
+
+		return fa;
+	}
+
+	//Primes of the form c * 2^k + 1 with k >= 25, used for the CRT products of other moduli and of integers
+	const std::uint32_t nttPrime1 = 2013265921;
+	const std::uint32_t nttPrime2 = 469762049;
+	const std::uint32_t nttPrime3 = 167772161;
+
+	//Largest transform, in bits, that all three primes support, 2^25 coefficients
+	inline std::size_t CrtTransformBits()
+	{
+		return std::min(TwoAdicity(nttPrime1), std::min(TwoAdicity(nttPrime2), TwoAdicity(nttPrime3)));
+	}
+
+	//Product of the three primes, about 2^86
+	inline long double CrtModulus()
+	{
+		return static_cast<long double>(nttPrime1) * nttPrime2 * nttPrime3;
+	}
+
+	/*
+		Garner's CRT over the three primes. Digits gives the mixed radix digits of the value
+		x = x1 + x2 m1 + x3 m1 m2 in [0, m1 m2 m3) with the given residues, x2 < m2 and x3 < m3.
+	*/
+	struct CrtReconstruction
+	{
+		ModInt<nttPrime2> inverse1 = ModInt<nttPrime2>(nttPrime1).Inverse();
+		ModInt<nttPrime3> inverse12 = (ModInt<nttPrime3>(nttPrime1) * ModInt<nttPrime3>(nttPrime2)).Inverse();
+
+		void Digits(const ModInt<nttPrime1> r1, const ModInt<nttPrime2> r2, const ModInt<nttPrime3> r3,
+			std::uint32_t& x1, std::uint32_t& x2, std::uint32_t& x3) const
+		{
+			x1 = r1.Value();
+			x2 = ((r2 - ModInt<nttPrime2>(x1)) * this->inverse1).Value();
+			x3 = ((r3 - ModInt<nttPrime3>(x1) - ModInt<nttPrime3>(nttPrime1) * ModInt<nttPrime3>(x2)) * this->inverse12).Value();
+		}
+	};
+
+	//Transform size, and its bits, for a product of resultSize coefficients
+	inline std::size_t TransformSize(const std::size_t resultSize, std::size_t& bits)
+	{
+		std::size_t size = 1;
+		bits = 0;
+		while (size < resultSize)
+		{
+			size <<= 1;
+			bits++;
+		}
+
+		return size;
+	}
+
+	/*
+		NTT based multiplication modulo P, O((n + m) log(n + m)) and exact. If P - 1 holds the transform size,
+		the product is transformed modulo P itself. Otherwise the integer product of the representatives is
+		computed modulo the three NTT primes, and each coefficient reconstructed modulo P by Garner's CRT.
+		That is exact while min(n, m) * (P - 1)^2 stays below the product of the primes, about 2^86.
+		Returns false, leaving out untouched, for products beyond 2^25 coefficients or that bound.
+	*/
+	template <std::uint32_t P> bool MultiplyNtt(const ModInt<P>* a, const std::size_t n, const ModInt<P>* b, const std::size_t m, ModInt<P>* out, Executor& executor)
+	{
+		const auto resultSize = n + m - 1;
+		std::size_t bits;
+		const auto size = TransformSize(resultSize, bits);
+
+		if (bits <= TwoAdicity(P))
+		{
+			auto product = ConvolveModulo<P>(a, n, b, m, size, executor);
+			std::copy(product.begin(), product.begin() + resultSize, out);
+
+			return true;
+		}
+
+		const auto bound = static_cast<long double>(std::min(n, m)) * (P - 1) * (P - 1);
+		if (bits > CrtTransformBits() || bound >= CrtModulus())
+		{
+			return false;
+		}
+
+		const auto r1 = ConvolveModulo<nttPrime1>(a, n, b, m, size, executor);
+		const auto r2 = ConvolveModulo<nttPrime2>(a, n, b, m, size, executor);
+		const auto r3 = ConvolveModulo<nttPrime3>(a, n, b, m, size, executor);
+
+		const CrtReconstruction crt;
+		const auto m1 = ModInt<P>(nttPrime1);
+		const auto m12 = m1 * ModInt<P>(nttPrime2);
+
+		ParallelFor(executor, resultSize, fftGrain, [&](const std::size_t begin, const std::size_t end) {
+			for (auto i = begin; i < end; i++)
+			{
+				std::uint32_t x1, x2, x3;
+				crt.Digits(r1[i], r2[i], r3[i], x1, x2, x3);
+
+				out[i] = ModInt<P>(x1) + m1 * ModInt<P>(x2) + m12 * ModInt<P>(x3);
+			}
+		});
+
+		return true;
+	}
+
+	/*
+		Multiplication of signed integers through the NTT modulo the three primes, O((n + m) log(n + m)).
+		bound limits the magnitude of every product coefficient. While it stays below a quarter of the product
+		of the primes, about 2^84, the CRT value tells the sign of each coefficient and its exact magnitude.
+		Coefficients are written modulo 2^bits like the other integer products, or, if checked, throw
+		std::overflow_error when they don't fit C. Returns false, leaving out untouched, for products beyond
+		2^25 coefficients or that bound.
+	*/
+	template <typename C> bool MultiplyNttIntegers(const C* a, const std::size_t n, const C* b, const std::size_t m, C* out,
+		const long double bound, const bool checked, Executor& executor)
+	{
+		typedef typename std::make_unsigned<C>::type U;
+
+		const auto resultSize = n + m - 1;
+		std::size_t bits;
+		const auto size = TransformSize(resultSize, bits);
+
+		if (bits > CrtTransformBits() || bound >= CrtModulus() / 4)
+		{
+			return false;
+		}
+
+		const auto r1 = ConvolveModulo<nttPrime1>(a, n, b, m, size, executor);
+		const auto r2 = ConvolveModulo<nttPrime2>(a, n, b, m, size, executor);
+		const auto r3 = ConvolveModulo<nttPrime3>(a, n, b, m, size, executor);
+
+		const CrtReconstruction crt;
+		const auto m1 = static_cast<std::uint64_t>(nttPrime1);
+		const auto m12 = m1 * nttPrime2;
+		const auto largest = static_cast<std::uint64_t>(std::numeric_limits<C>::max());
+		std::atomic<bool> overflow(false);
+
+		ParallelFor(executor, resultSize, fftGrain, [&](const std::size_t begin, const std::size_t end) {
+			for (auto i = begin; i < end; i++)
+			{
+				std::uint32_t x1, x2, x3;
+				crt.Digits(r1[i], r2[i], r3[i], x1, x2, x3);
+
+				//x3 is below a quarter of m3 for values in [0, bound], and above three quarters for negative values
+				const auto negative = x3 > nttPrime3 / 2;
+				if (negative)
+				{
+					crt.Digits(-r1[i], -r2[i], -r3[i], x1, x2, x3);
+				}
+
+				//Modulo 2^64, and exact when m1 m2 x3 fits C
+				const auto magnitude = x1 + m1 * x2 + m12 * x3;
+				if (checked && (static_cast<long double>(m12) * x3 > largest || magnitude > largest + (negative ? 1 : 0)))
+				{
+					overflow.store(true, std::memory_order_relaxed);
+					continue;
+				}
+
+				reinterpret_cast<U*>(out)[i] = static_cast<U>(negative ? 0 - magnitude : magnitude);
+			}
+		});
+
+		if (overflow.load())
+		{
+			throw std::overflow_error("The product overflows the coefficient type");
+		}
+
+		return true;
+	}
+
+	/*
+		FFT tag dispatch. Rounding errors make FFT unsuitable for exact products, so modular types use the
+		number theoretic transform, and unsigned integer types Karatsuba. Signed integers don't get here, see MultiplyIntegers.
+	*/
+	template <typename C> void MultiplyLarge(const C* a, const std::size_t n, const C* b, const std::size_t m, C* out, const std::size_t, Executor& executor, std::true_type)
+	{
+		PolynomialInstrumentation::Count(PolynomialCounter::FftMultiplications);
+		MultiplyFft(a, n, b, m, out, executor);
+	}
+
+	template <typename C> void MultiplyLarge(const C* a, const std::size_t n, const C* b, const std::size_t m, C* out, const std::size_t karatsubaThreshold, Executor& executor, std::false_type)
+	{
+		PolynomialInstrumentation::Count(PolynomialCounter::KaratsubaMultiplications);
+		MultiplyKaratsuba(a, n, b, m, out, karatsubaThreshold, executor);
+	}
+
+	//Modular coefficients are exact under the number theoretic transform
+	template <std::uint32_t P> void MultiplyLarge(const ModInt<P>* a, const std::size_t n, const ModInt<P>* b, const std::size_t m, ModInt<P>* out,
+		const std::size_t karatsubaThreshold, Executor& executor, std::false_type)
+	{
+		if (MultiplyNtt(a, n, b, m, out, executor))
+		{
+			PolynomialInstrumentation::Count(PolynomialCounter::NttMultiplications);
+			return;
+		}
+
+		PolynomialInstrumentation::Count(PolynomialCounter::KaratsubaMultiplications);
+		MultiplyKaratsuba(a, n, b, m, out, karatsubaThreshold, executor);
+	}
+
+	/*
+		Picks the algorithm from the length m of the shorter operand: schoolbook below karatsubaThreshold,
+		FFT from fftThreshold, and Karatsuba in between. Large products split their work across the executor:
+		schoolbook by output tiles, Karatsuba by its top level sub-products, and FFT by the stages of the transforms.
+	*/
+	template <typename C> void MultiplyBySize(const C* a, const std::size_t n, const C* b, const std::size_t m, C* out,
+		const std::size_t karatsubaThreshold, const std::size_t fftThreshold, Executor& executor)
+	{
+		if (m < karatsubaThreshold)
+		{
+			PolynomialInstrumentation::Count(PolynomialCounter::SchoolbookMultiplications);
+			MultiplySchoolbookTiled(a, n, b, m, out, executor);
+		}
+		else if (m < fftThreshold)
+		{
+			PolynomialInstrumentation::Count(PolynomialCounter::KaratsubaMultiplications);
+			MultiplyKaratsuba(a, n, b, m, out, karatsubaThreshold, executor);
+		}
+		else
+		{
+			typename std::is_floating_point<C>::type isFloatingPoint;
+			MultiplyLarge(a, n, b, m, out, karatsubaThreshold, executor, isFloatingPoint);
+		}
+	}
+
+	//Largest possible magnitude of a product coefficient, min(n, m) * max |a[i]| * max |b[j]|
+	template <typename C> long double ProductBound(const C* a, const std::size_t n, const C* b, const std::size_t m)
+	{
+		long double largestA = 0;
+		long double largestB = 0;
+
+		for (std::size_t i = 0; i < n; i++)
+		{
+			largestA = std::max(largestA, std::abs(static_cast<long double>(a[i])));
+		}
+
+		for (std::size_t j = 0; j < m; j++)
+		{
+			largestB = std::max(largestB, std::abs(static_cast<long double>(b[j])));
+		}
+
+		return static_cast<long double>(std::min(n, m)) * largestA * largestB;
+	}
+
+	/*
+		Signed integer products are computed in the unsigned type of the same width, where the sums of Karatsuba
+		wrap harmlessly, so they come out modulo 2^bits without undefined behaviour. From fftThreshold the exact
+		NTT product is used while the transforms hold it.
+
+		If checked, they are exact or throw std::overflow_error instead. While the product bound fits C, nothing
+		wraps and the unsigned product is the exact one. Otherwise the exact NTT product is checked against C,
+		and beyond its 2^25 coefficients the product throws without being computed.
+	*/
+	template <typename C> void MultiplyIntegers(const C* a, const std::size_t n, const C* b, const std::size_t m, C* out,
+		const std::size_t karatsubaThreshold, const std::size_t fftThreshold, const bool checked, Executor& executor)
+	{
+		typedef typename std::make_unsigned<C>::type U;
+
+		const auto small = m < fftThreshold;
+		const auto bound = checked || !small ? ProductBound(a, n, b, m) : 0;
+		const auto fits = bound <= static_cast<long double>(std::numeric_limits<C>::max());
+
+		if (small && (fits || !checked))
+		{
+			MultiplyBySize(reinterpret_cast<const U*>(a), n, reinterpret_cast<const U*>(b), m, reinterpret_cast<U*>(out), karatsubaThreshold, fftThreshold, executor);
+			return;
+		}
+
+		if (MultiplyNttIntegers(a, n, b, m, out, bound, checked, executor))
+		{
+			PolynomialInstrumentation::Count(PolynomialCounter::NttMultiplications);
+			return;
+		}
+
+		if (checked && !fits)
+		{
+			throw std::overflow_error("The product may overflow the coefficient type, and is too large to check");
+		}
+
+		PolynomialInstrumentation::Count(PolynomialCounter::KaratsubaMultiplications);
+		MultiplyKaratsuba(reinterpret_cast<const U*>(a), n, reinterpret_cast<const U*>(b), m, reinterpret_cast<U*>(out), karatsubaThreshold, executor);
+	}
+
+	//Signed integer tag dispatch, see MultiplyIntegers
+	template <typename C> void MultiplyDispatch(const C* a, const std::size_t n, const C* b, const std::size_t m, C* out,
+		const std::size_t karatsubaThreshold, const std::size_t fftThreshold, const bool, Executor& executor, std::false_type)
+	{
+		MultiplyBySize(a, n, b, m, out, karatsubaThreshold, fftThreshold, executor);
+	}
+
+	template <typename C> void MultiplyDispatch(const C* a, const std::size_t n, const C* b, const std::size_t m, C* out,
+		const std::size_t karatsubaThreshold, const std::size_t fftThreshold, const bool checked, Executor& executor, std::true_type)
+	{
+		MultiplyIntegers(a, n, b, m, out, karatsubaThreshold, fftThreshold, checked, executor);
+	}
+
+	/*
+		Multiplies a (n coefficients) with b (m coefficients), writing the n + m - 1 coefficients of the product to out.
+		The algorithm is picked from the length of the shorter operand, see MultiplyBySize. Floating point types use
+		FFT from fftThreshold, and modular and signed integer types use the exact number theoretic transform.
+		Signed integer products wrap modulo 2^bits, or with checked throw std::overflow_error, see MultiplyIntegers.
+	*/
+	template <typename C> void Multiply(const C* a, std::size_t n, const C* b, std::size_t m, C* out,
+		const std::size_t karatsubaThreshold, const std::size_t fftThreshold, Executor& executor, const bool checked = false)
+	{
+		if (n < m)
+		{
+			std::swap(a, b);
+			std::swap(n, m);
+		}
+
+		if (m == 0)
+		{
+			return;
+		}
+
+		std::integral_constant<bool, std::is_integral<C>::value && std::is_signed<C>::value> isSignedIntegral;
+		MultiplyDispatch(a, n, b, m, out, karatsubaThreshold, fftThreshold, checked, executor, isSignedIntegral);
+	}
+
+	/*
+		Multiplication settings, bundled for the algorithms built on top of Multiply.
+	*/
+	struct Multiplier
+	{
+		std::size_t karatsubaThreshold;
+		std::size_t fftThreshold;
+		Executor& executor;
+
+		template <typename C> void operator()(const C* a, const std::size_t n, const C* b, const std::size_t m, C* out) const
+		{
+			Multiply(a, n, b, m, out, this->karatsubaThreshold, this->fftThreshold, this->executor);
+		}
+
+		template <typename C> std::vector<C> operator()(const std::vector<C>& a, const std::vector<C>& b) const
+		{
+			auto res = std::vector<C>(a.empty() || b.empty() ? 0 : a.size() + b.size() - 1);
+			(*this)(a.data(), a.size(), b.data(), b.size(), res.data());
+
+			return res;
+		}
+	};
+
+	//Expands the product of the linear factors (x - root) directly, O(k^2)
+	template <typename C> std::vector<C> ExpandLinearFactors(const C* roots, const std::size_t k)
+	{
+		auto res = std::vector<C>(1, C(1));
+		res.reserve(k + 1);
+
+		for (std::size_t r = 0; r < k; r++)
+		{
+			res.push_back(0);
+
+			for (auto i = res.size() - 1; i > 0; i--)
+			{
+				res[i] = res[i - 1] - roots[r] * res[i];
+			}
+
+			res[0] = -roots[r] * res[0];
+		}
+
+		return res;
+	}
+
+	//Number of linear factors expanded directly at the leaves of a product tree
+	const std::size_t productTreeLeafSize = 8;
+
+	/*
+		Leaf level of a product tree: the products of the linear factors (x - point) for consecutive groups of points.
+	*/
+	template <typename C> std::vector<std::vector<C>> LeafProducts(const C* points, const std::size_t k, const Multiplier& multiply)
+	{
+		auto level = std::vector<std::vector<C>>((k + productTreeLeafSize - 1) / productTreeLeafSize);
+
+		ParallelFor(multiply.executor, level.size(), 64, [&](const std::size_t begin, const std::size_t end) {
+			for (auto i = begin; i < end; i++)
+			{
+				const auto first = i * productTreeLeafSize;
+				level[i] = ExpandLinearFactors(points + first, std::min(productTreeLeafSize, k - first));
+			}
+		});
+
+		return level;
+	}
+
+	/*
+		Next level of a product tree, multiplying pairs from the given level with fast multiplication.
+		The products are independent and run in parallel.
+	*/
+	template <typename C> std::vector<std::vector<C>> NextProductLevel(const std::vector<std::vector<C>>& level, const Multiplier& multiply)
+	{
+		auto next = std::vector<std::vector<C>>((level.size() + 1) / 2);
+
+		//Few large products parallelize internally, many small ones are spread across the executor
+		const auto size = level[0].size();
+		const auto grain = std::max<std::size_t>(1, parallelWorkThreshold / (size * size));
+
+		ParallelFor(multiply.executor, next.size(), grain, [&](const std::size_t begin, const std::size_t end) {
+			for (auto i = begin; i < end; i++)
+			{
+				next[i] = 2 * i + 1 < level.size() ? multiply(level[2 * i], level[2 * i + 1]) : level[2 * i];
+			}
+		});
+
+		return next;
+	}
+
+	/*
+		Computes the product of the linear factors (x - root) of k roots using a balanced product tree,
+		in O(M(k) log k) time for multiplication cost M. Only the current level is kept.
+	*/
+	template <typename C> std::vector<C> RootProduct(const C* roots, const std::size_t k, const Multiplier& multiply)
+	{
+		auto level = LeafProducts(roots, k, multiply);
+
+		while (level.size() > 1)
+		{
+			level = NextProductLevel(level, multiply);
+		}
+
+		return level.empty() ? std::vector<C>(1, C(1)) : std::move(level[0]);
+	}
+
+	/*
+		Subproduct tree over a set of points. levels[0] holds the leaf products of groups of points,
+		and each level above the products of pairs from the level below, up to a single polynomial.
+	*/
+	template <typename C> struct SubproductTree
+	{
+		std::vector<std::vector<std::vector<C>>> levels;
+	};
+
+	template <typename C> SubproductTree<C> BuildSubproductTree(const C* points, const std::size_t k, const Multiplier& multiply)
+	{
+		SubproductTree<C> tree;
+		tree.levels.push_back(LeafProducts(points, k, multiply));
+
+		while (tree.levels.back().size() > 1)
+		{
+			auto next = NextProductLevel(tree.levels.back(), multiply);
+			tree.levels.push_back(std::move(next));
+		}
+
+		return tree;
+	}
+
+	/*
+		Inverse of the power series f modulo x^n, by Newton iteration g = g(2 - fg),
+		doubling the number of correct terms each step. f[0] must be invertible.
+	*/
+	template <typename C> std::vector<C> SeriesInverse(const std::vector<C>& f, const std::size_t n, const Multiplier& multiply)
+	{
+		auto g = std::vector<C>(1, C(1) / f[0]);
+
+		for (std::size_t k = 1; k < n;)
+		{
+			const auto k2 = std::min(2 * k, n);
+
+			//e = 2 - f*g mod x^k2
+			auto e = multiply(std::vector<C>(f.begin(), f.begin() + std::min(f.size(), k2)), g);
+			e.resize(k2);
+			for (auto& c : e)
+			{
+				c = -c;
+			}
+			e[0] += 2;
+
+			g = multiply(g, e);
+			g.resize(k2);
+			k = k2;
+		}
+
+		g.resize(n);
+		return g;
+	}
+
+	/*
+		Schoolbook long division in place, O((n - m + 1) * m), needs n >= m. On entry r holds the n coefficients
+		of the dividend, on exit it holds the remainder in r[0, m - 1) and the quotient in r[m - 1, n).
+	*/
+	template <typename C> void DivideInPlace(C* r, const std::size_t n, const C* b, const std::size_t m)
+	{
+		const auto lead = b[m - 1];
+
+		for (auto i = n - m + 1; i > 0; i--)
+		{
+			//The top coefficient is eliminated by this step, so its slot is free for the quotient coefficient
+			const auto top = i - 1 + m - 1;
+			const C q = r[top] / lead;
+			r[top] = q;
+
+			for (std::size_t j = 0; j + 1 < m; j++)
+			{
+				r[i - 1 + j] -= q * b[j];
+			}
+		}
+	}
+
+	//Schoolbook long division, O((n - m) * m)
+	template <typename C> void DivideSchoolbook(const std::vector<C>& a, const std::vector<C>& b, std::vector<C>& quotient, std::vector<C>& remainder)
+	{
+		const auto m = b.size();
+
+		remainder = a;
+		DivideInPlace(remainder.data(), a.size(), b.data(), m);
+
+		quotient.assign(remainder.begin() + (m - 1), remainder.end());
+		remainder.resize(m - 1);
+	}
+
+	/*
+		Divides a by b, giving quotient and remainder with a = quotient * b + remainder.
+		The leading coefficient of b must be non-zero. Large divisions compute the reversed quotient
+		as rev(a) * rev(b)^-1 mod x^(n - m + 1), using Newton inversion on top of fast multiplication.
+	*/
+	template <typename C> void DivideRemainder(const std::vector<C>& a, const std::vector<C>& b, std::vector<C>& quotient, std::vector<C>& remainder, const Multiplier& multiply)
+	{
+		const auto n = a.size();
+		const auto m = b.size();
+
+		if (n < m)
+		{
+			quotient.clear();
+			remainder = a;
+			return;
+		}
+
+		const auto qn = n - m + 1;
+
+		if (std::min(qn, m) < 2 * multiply.karatsubaThreshold)
+		{
+			DivideSchoolbook(a, b, quotient, remainder);
+			return;
+		}
+
+		auto reversedA = std::vector<C>(a.rbegin(), a.rbegin() + qn);
+		auto reversedB = std::vector<C>(b.rbegin(), b.rend());
+
+		quotient = multiply(reversedA, SeriesInverse(reversedB, qn, multiply));
+		quotient.resize(qn);
+		std::reverse(quotient.begin(), quotient.end());
+
+		//remainder = a - b * quotient, of which only the low m - 1 coefficients are non-zero
+		auto product = multiply(b, quotient);
+		remainder.assign(a.begin(), a.begin() + (m - 1));
+		for (std::size_t i = 0; i < m - 1; i++)
+		{
+			remainder[i] -= product[i];
+		}
+	}
+
+	/*
+		Evaluates the n points of a subproduct tree using a remainder tree.
+		The polynomial is reduced modulo each node of the tree, top down,
+		and the small remainders at the leaves are evaluated with Horner.
+	*/
+	template <typename C> void EvaluateOnTree(const C* coefficients, const std::size_t count, const SubproductTree<C>& tree, const C* x, C* out, const std::size_t n, const Multiplier& multiply)
+	{
+		std::vector<C> quotient;
+		auto remainders = std::vector<std::vector<C>>(1);
+		DivideRemainder(std::vector<C>(coefficients, coefficients + count), tree.levels.back()[0], quotient, remainders[0], multiply);
+
+		for (auto level = tree.levels.size() - 1; level > 0; level--)
+		{
+			auto& nodes = tree.levels[level - 1];
+			auto next = std::vector<std::vector<C>>(nodes.size());
+
+			const auto size = nodes[0].size();
+			const auto grain = std::max<std::size_t>(1, parallelWorkThreshold / (size * size));
+
+			ParallelFor(multiply.executor, nodes.size(), grain, [&](const std::size_t begin, const std::size_t end) {
+				std::vector<C> q;
+				for (auto i = begin; i < end; i++)
+				{
+					DivideRemainder(remainders[i / 2], nodes[i], q, next[i], multiply);
+				}
+			});
+
+			remainders = std::move(next);
+		}
+
+		//Evaluate the remainders at the points of each leaf
+		for (std::size_t p = 0; p < n; p++)
+		{
+			auto& r = remainders[p / productTreeLeafSize];
+			out[p] = Horner(r.data(), r.size(), x[p]);
+		}
+	}
+
+	/*
+		Evaluates n points at once using a remainder tree, O(M(n) log n) for n points and a polynomial of degree about n.
+	*/
+	template <typename C> void EvaluateMultipoint(const C* coefficients, const std::size_t count, const C* x, C* out, const std::size_t n, const Multiplier& multiply)
+	{
+		if (n == 0)
+		{
+			return;
+		}
+
+		auto tree = BuildSubproductTree(x, n, multiply);
+		EvaluateOnTree(coefficients, count, tree, x, out, n, multiply);
+	}
+
+	/*
+		Interpolation through n points by Newton divided differences, O(n^2) and without scratch memory.
+		The divided differences are built in out, and then expanded from the Newton form to coefficients in place.
+		Returns false, leaving out undefined, if two points coincide.
+	*/
+	template <typename C> bool InterpolateNewton(const C* x, const C* y, const std::size_t n, C* out)
+	{
+		std::copy(y, y + n, out);
+
+		//out[i] becomes f[x_0, ..., x_i]
+		for (std::size_t k = 1; k < n; k++)
+		{
+			for (auto i = n - 1; i >= k; i--)
+			{
+				const C distance = x[i] - x[i - k];
+
+				if (distance == C(0))
+				{
+					return false;
+				}
+
+				out[i] = (out[i] - out[i - 1]) / distance;
+			}
+		}
+
+		//Multiply out c_0 + (x - x_0)(c_1 + (x - x_1)(c_2 + ...)) from the inside
+		for (auto k = n - 1; k-- > 0;)
+		{
+			for (auto i = k; i + 1 < n; i++)
+			{
+				out[i] -= x[k] * out[i + 1];
+			}
+		}
+
+		return true;
+	}
+
+	/*
+		Fast interpolation through n points on a subproduct tree, O(M(n) log n).
+		With M the product of all (x - x_i), the Lagrange weights y_i / M'(x_i) come from a remainder tree,
+		and the weighted sums of M / (x - x_i) are combined up the tree as left * M_right + right * M_left.
+		Returns false, leaving out undefined, if two points coincide. Writes n coefficients to out.
+	*/
+	template <typename C> bool InterpolateFast(const C* x, const C* y, const std::size_t n, C* out, const Multiplier& multiply)
+	{
+		auto tree = BuildSubproductTree(x, n, multiply);
+		auto& root = tree.levels.back()[0];
+
+		auto derivative = std::vector<C>(n);
+		for (std::size_t i = 1; i <= n; i++)
+		{
+			derivative[i - 1] = root[i] * static_cast<C>(i);
+		}
+
+		auto weights = std::vector<C>(n);
+		EvaluateOnTree(derivative.data(), n, tree, x, weights.data(), n, multiply);
+
+		for (std::size_t i = 0; i < n; i++)
+		{
+			if (weights[i] == C(0))
+			{
+				return false;
+			}
+
+			weights[i] = y[i] / weights[i];
+		}
+
+		//Leaves: sum of w_i * N / (x - x_i) for the leaf product N, dividing out each factor synthetically
+		auto& leaves = tree.levels[0];
+		auto level = std::vector<std::vector<C>>(leaves.size());
+
+		for (std::size_t l = 0; l < leaves.size(); l++)
+		{
+			auto& node = leaves[l];
+			const auto size = node.size() - 1;
+			level[l].assign(size, C(0));
+
+			for (std::size_t p = 0; p < size; p++)
+			{
+				const auto point = x[l * productTreeLeafSize + p];
+				const auto weight = weights[l * productTreeLeafSize + p];
+
+				C q = node[size];
+				for (auto i = size; i > 0; i--)
+				{
+					level[l][i - 1] += weight * q;
+					q = node[i - 1] + point * q;
+				}
+			}
+		}
+
+		//Combine pairs up the tree
+		for (std::size_t depth = 0; level.size() > 1; depth++)
+		{
+			auto& nodes = tree.levels[depth];
+			auto next = std::vector<std::vector<C>>((level.size() + 1) / 2);
+
+			const auto size = nodes[0].size();
+			const auto grain = std::max<std::size_t>(1, parallelWorkThreshold / (size * size));
+
+			ParallelFor(multiply.executor, next.size(), grain, [&](const std::size_t begin, const std::size_t end) {
+				for (auto i = begin; i < end; i++)
+				{
+					if (2 * i + 1 == level.size())
+					{
+						next[i] = std::move(level[2 * i]);
+						continue;
+					}
+
+					next[i] = multiply(level[2 * i], nodes[2 * i + 1]);
+					auto other = multiply(level[2 * i + 1], nodes[2 * i]);
+
+					for (std::size_t j = 0; j < other.size(); j++)
+					{
+						next[i][j] += other[j];
+					}
+				}
+			});
+
+			level = std::move(next);
+		}
+
+		std::copy(level[0].begin(), level[0].end(), out);
+
+		return true;
+	}
+
+	//Taylor shift p(x + a) in place, O(n^2) additions and multiplications
+	template <typename C> void ShiftInPlace(C* coefficients, const std::size_t n, const C a)
+	{
+		for (std::size_t i = 0; i + 1 < n; i++)
+		{
+			for (auto j = n - 1; j-- > i;)
+			{
+				coefficients[j] += a * coefficients[j + 1];
+			}
+		}
+	}
+
+	//Number of coefficients composed with Horner at the leaves of the composition recursion
+	const std::size_t composeLeafSize = 8;
+
+	/*
+		Composes the n coefficients from p with q, given powers[k] = q^(composeLeafSize * 2^k).
+		Splits p = low + x^h high into p(q) = low(q) + q^h high(q), down to Horner at the leaves.
+	*/
+	template <typename C> std::vector<C> ComposeRange(const C* p, const std::size_t n, const std::vector<C>& q,
+		const std::vector<std::vector<C>>& powers, const std::size_t level, const Multiplier& multiply)
+	{
+		if (level == 0)
+		{
+			auto res = std::vector<C>(1, p[n - 1]);
+
+			for (auto i = n - 1; i > 0; i--)
+			{
+				res = multiply(res, q);
+				res[0] += p[i - 1];
+			}
+
+			return res;
+		}
+
+		const auto h = composeLeafSize << (level - 1);
+
+		if (n <= h)
+		{
+			return ComposeRange(p, n, q, powers, level - 1, multiply);
+		}
+
+		auto res = ComposeRange(p, h, q, powers, level - 1, multiply);
+		auto high = multiply(ComposeRange(p + h, n - h, q, powers, level - 1, multiply), powers[level - 1]);
+
+		res.resize(std::max(res.size(), high.size()), C(0));
+		for (std::size_t i = 0; i < high.size(); i++)
+		{
+			res[i] += high[i];
+		}
+
+		return res;
+	}
+
+	/*
+		Composition p(q(x)) of n coefficients from p with q by divide and conquer, O(M(nm) log n)
+		for q of m coefficients and multiplication cost M. Taylor shifts are compositions with x + a.
+	*/
+	template <typename C> std::vector<C> Compose(const C* p, const std::size_t n, const std::vector<C>& q, const Multiplier& multiply)
+	{
+		//Powers of q for each level of the recursion, squared up from q^composeLeafSize
+		auto powers = std::vector<std::vector<C>>();
+		std::size_t level = 0;
+
+		if (n > composeLeafSize)
+		{
+			auto power = std::vector<C>(1, C(1));
+			for (std::size_t i = 0; i < composeLeafSize; i++)
+			{
+				power = multiply(power, q);
+			}
+
+			powers.push_back(std::move(power));
+			level = 1;
+
+			while ((composeLeafSize << level) < n)
+			{
+				powers.push_back(multiply(powers.back(), powers.back()));
+				level++;
+			}
+		}
+
+		return ComposeRange(p, n, q, powers, level, multiply);
+	}
+
+	/*
+		A single non-zero term of a sparse polynomial, value * x^exponent.
+		Sparse polynomials keep their terms sorted by exponent.
+	*/
+	template <typename C> struct Term
+	{
+		std::size_t exponent;
+		C value;
+	};
+
+	//Computes x^exponent by exponentiation by squaring
+	template <typename C> C Power(C x, std::size_t exponent)
+	{
+		C res = 1;
+
+		while (exponent > 0)
+		{
+			if (exponent & 1)
+			{
+				res *= x;
+			}
+
+			x *= x;
+			exponent >>= 1;
+		}
+
+		return res;
+	}
+
+	/*
+		Evaluates sparse terms at a single point.
+		The power of x is carried from term to term, squaring only over the gaps between exponents.
+	*/
+	template <typename C> C EvaluateSparse(const std::vector<Term<C>>& terms, const C x)
+	{
+		C res = 0;
+		C power = 1;
+		std::size_t exponent = 0;
+
+		for (auto& t : terms)
+		{
+			power *= Power(x, t.exponent - exponent);
+			exponent = t.exponent;
+
+			res += t.value * power;
+		}
+
+		return res;
+	}
+
+	//Collects the non-zero coefficients of a dense buffer as terms
+	template <typename C> std::vector<Term<C>> ToTerms(const C* coefficients, const std::size_t count)
+	{
+		auto terms = std::vector<Term<C>>();
+
+		for (std::size_t i = 0; i < count; i++)
+		{
+			if (coefficients[i] != C(0))
+			{
+				terms.push_back({ i, coefficients[i] });
+			}
+		}
+
+		return terms;
+	}
+
+	//Expands terms into a dense buffer of count coefficients
+	template <typename C> std::vector<C> ToDense(const std::vector<Term<C>>& terms, const std::size_t count)
+	{
+		auto coefficients = std::vector<C>(count, C(0));
+
+		for (auto& t : terms)
+		{
+			coefficients[t.exponent] = t.value;
+		}
+
+		return coefficients;
+	}
+
+	//Adds two sparse polynomials by merging their terms, dropping terms that cancel out
+	template <typename C> std::vector<Term<C>> AddSparse(const std::vector<Term<C>>& a, const std::vector<Term<C>>& b)
+	{
+		auto res = std::vector<Term<C>>();
+		res.reserve(a.size() + b.size());
+
+		auto i = a.begin();
+		auto j = b.begin();
+
+		while (i != a.end() || j != b.end())
+		{
+			if (j == b.end() || (i != a.end() && i->exponent < j->exponent))
+			{
+				res.push_back(*i++);
+			}
+			else if (i == a.end() || j->exponent < i->exponent)
+			{
+				res.push_back(*j++);
+			}
+			else
+			{
+				const C value = i->value + j->value;
+				if (value != C(0))
+				{
+					res.push_back({ i->exponent, value });
+				}
+
+				i++;
+				j++;
+			}
+		}
+
+		return res;
+	}
+
+	/*
+		Multiplies two sparse polynomials, O(t1*t2 log(t1*t2)) in the number of terms.
+		All pairwise products are formed, sorted by exponent and merged.
+	*/
+	//Whether a term by term product of signed integers may overflow C, by the bound of ProductBound
+	template <typename C> bool SparseProductMayOverflow(const std::vector<Term<C>>&, const std::vector<Term<C>>&, std::false_type)
+	{
+		return false;
+	}
+
+	template <typename C> bool SparseProductMayOverflow(const std::vector<Term<C>>& a, const std::vector<Term<C>>& b, std::true_type)
+	{
+		long double largestA = 0;
+		long double largestB = 0;
+
+		for (auto& t : a)
+		{
+			largestA = std::max(largestA, std::abs(static_cast<long double>(t.value)));
+		}
+
+		for (auto& t : b)
+		{
+			largestB = std::max(largestB, std::abs(static_cast<long double>(t.value)));
+		}
+
+		return static_cast<long double>(std::min(a.size(), b.size())) * largestA * largestB > static_cast<long double>(std::numeric_limits<C>::max());
+	}
+
+	template <typename C> std::vector<Term<C>> MultiplySparse(const std::vector<Term<C>>& a, const std::vector<Term<C>>& b)
+	{
+		auto products = std::vector<Term<C>>();
+		products.reserve(a.size() * b.size());
+
+		for (auto& ta : a)
+		{
+			for (auto& tb : b)
+			{
+				products.push_back({ ta.exponent + tb.exponent, ta.value * tb.value });
+			}
+		}
+
+		std::sort(products.begin(), products.end(), [](const Term<C>& l, const Term<C>& r) { return l.exponent < r.exponent; });
+
+		//Merge equal exponents
+		auto res = std::vector<Term<C>>();
+		for (auto& t : products)
+		{
+			if (!res.empty() && res.back().exponent == t.exponent)
+			{
+				res.back().value += t.value;
+			}
+			else
+			{
+				if (!res.empty() && res.back().value == C(0))
+				{
+					res.pop_back();
+				}
+
+				res.push_back(t);
+			}
+		}
+
+		if (!res.empty() && res.back().value == C(0))
+		{
+			res.pop_back();
+		}
+
+		return res;
+	}
+
+	//Derivative of a sparse polynomial
+	template <typename C> std::vector<Term<C>> DerivativeSparse(const std::vector<Term<C>>& terms)
+	{
+		auto res = std::vector<Term<C>>();
+		res.reserve(terms.size());
+
+		for (auto& t : terms)
+		{
+			if (t.exponent > 0)
+			{
+				res.push_back({ t.exponent - 1, t.value * static_cast<C>(t.exponent) });
+			}
+		}
+
+		return res;
+	}
+
+	//Antiderivative of a sparse polynomial, with a zero constant term
+	template <typename C> std::vector<Term<C>> IntegrateSparse(const std::vector<Term<C>>& terms)
+	{
+		auto res = std::vector<Term<C>>();
+		res.reserve(terms.size());
+
+		for (auto& t : terms)
+		{
+			res.push_back({ t.exponent + 1, t.value / static_cast<C>(t.exponent + 1) });
+		}
+
+		return res;
+	}
+
+	//Antiderivative of count coefficients, with a zero constant term. Writes count + 1 coefficients to out.
+	template <typename C> void Integrate(const C* coefficients, const std::size_t count, C* out)
+	{
+		out[0] = 0;
+
+		for (std::size_t i = 0; i < count; i++)
+		{
+			out[i + 1] = coefficients[i] / static_cast<C>(i + 1);
+		}
+	}
+
+	/*
+		Logarithmic derivative p'(z) / p(z) of the polynomial with count coefficients.
+		Outside the unit circle it evaluates the reversed polynomial at 1 / z instead, so high degrees don't overflow.
+		Sets zero and returns 0 if p(z) is 0.
+	*/
+	template <typename R> std::complex<R> LogDerivative(const R* coefficients, const std::size_t count, const std::complex<R> z, bool& zero)
+	{
+		std::complex<R> p = 0;
+		std::complex<R> d = 0;
+
+		if (std::norm(z) <= R(1))
+		{
+			for (auto i = count; i > 0; i--)
+			{
+				d = d * z + p;
+				p = p * z + coefficients[i - 1];
+			}
+
+			zero = p == std::complex<R>(0);
+
+			return zero ? std::complex<R>(0) : d / p;
+		}
+
+		//p(z) = z^n rev(y) with y = 1 / z, so p'(z) / p(z) = (n - y rev'(y) / rev(y)) y
+		const auto y = R(1) / z;
+
+		for (std::size_t i = 0; i < count; i++)
+		{
+			d = d * y + p;
+			p = p * y + coefficients[i];
+		}
+
+		zero = p == std::complex<R>(0);
+
+		return zero ? std::complex<R>(0) : (static_cast<R>(count - 1) - y * d / p) * y;
+	}
+
+	/*
+		Aberth-Ehrlich iteration for the roots of the polynomial with count coefficients, the lowest and highest nonzero.
+		The roots start spread over circles fitted to the coefficients, and every iteration then updates each root
+		from the previous values of the others, so an iteration is split across the executor. Roots are kept
+		as separate real and imaginary parts, which lets the compiler vectorize the sums over the other roots.
+		A root is left alone once its correction is below tolerance * max(1, |root|).
+		Writes count - 1 roots and returns the number of iterations, setting converged if all roots converged.
+	*/
+	template <typename R> std::size_t FindRootsAberth(const R* coefficients, const std::size_t count, std::complex<R>* roots,
+		const R tolerance, const std::size_t maxIterations, bool& converged, Executor& executor)
+	{
+		const auto n = count - 1;
+
+		/*
+			Start on circles given by the upper convex hull of the points (i, log |a_i|), the Newton polygon,
+			with one circle per hull edge holding as many roots as the edge is wide.
+		*/
+		auto hull = std::vector<std::size_t>();
+		for (std::size_t i = 0; i < count; i++)
+		{
+			if (coefficients[i] == R(0))
+			{
+				continue;
+			}
+
+			const auto y = std::log(std::abs(coefficients[i]));
+
+			while (hull.size() >= 2)
+			{
+				const auto a = hull[hull.size() - 2];
+				const auto b = hull.back();
+				const auto ya = std::log(std::abs(coefficients[a]));
+				const auto yb = std::log(std::abs(coefficients[b]));
+
+				//Drop b if it lies on or below the line from a to i
+				if ((yb - ya) * static_cast<R>(i - a) > (y - ya) * static_cast<R>(b - a))
+				{
+					break;
+				}
+
+				hull.pop_back();
+			}
+
+			hull.push_back(i);
+		}
+
+		std::vector<R> re(n);
+		std::vector<R> im(n);
+		const R pi = std::acos(R(-1));
+		std::size_t k = 0;
+
+		for (std::size_t e = 0; e + 1 < hull.size(); e++)
+		{
+			const auto width = hull[e + 1] - hull[e];
+			const auto radius = std::pow(std::abs(coefficients[hull[e]] / coefficients[hull[e + 1]]), R(1) / static_cast<R>(width));
+
+			//The angular offsets keep the start away from the symmetry of real coefficients
+			for (std::size_t l = 0; l < width; l++, k++)
+			{
+				const auto angle = 2 * pi * static_cast<R>(l) / static_cast<R>(width) + 2 * pi * static_cast<R>(e) / static_cast<R>(n) + R(0.4);
+				re[k] = radius * std::cos(angle);
+				im[k] = radius * std::sin(angle);
+			}
+		}
+
+		std::vector<R> stepRe(n);
+		std::vector<R> stepIm(n);
+		std::vector<char> done(n, 0);
+		std::size_t remaining = n;
+		std::size_t iteration = 0;
+
+		const auto grain = std::max<std::size_t>(1, parallelWorkThreshold / (2 * count));
+
+		while (remaining > 0 && iteration < maxIterations)
+		{
+			iteration++;
+
+			ParallelFor(executor, n, grain, [&](const std::size_t begin, const std::size_t end) {
+				for (auto i = begin; i < end; i++)
+				{
+					stepRe[i] = 0;
+					stepIm[i] = 0;
+
+					if (done[i])
+					{
+						continue;
+					}
+
+					const std::complex<R> z(re[i], im[i]);
+					auto zero = false;
+					const auto logDerivative = LogDerivative(coefficients, count, z, zero);
+
+					if (zero)
+					{
+						continue;
+					}
+
+					//Sum of 1 / (z - z_j) over the other roots
+					R sumRe = 0;
+					R sumIm = 0;
+
+					for (std::size_t j = 0; j < i; j++)
+					{
+						const auto dr = z.real() - re[j];
+						const auto di = z.imag() - im[j];
+						const auto scale = R(1) / (dr * dr + di * di);
+						sumRe += dr * scale;
+						sumIm -= di * scale;
+					}
+
+					for (auto j = i + 1; j < n; j++)
+					{
+						const auto dr = z.real() - re[j];
+						const auto di = z.imag() - im[j];
+						const auto scale = R(1) / (dr * dr + di * di);
+						sumRe += dr * scale;
+						sumIm -= di * scale;
+					}
+
+					const auto denominator = logDerivative - std::complex<R>(sumRe, sumIm);
+
+					if (denominator != std::complex<R>(0))
+					{
+						const auto step = R(1) / denominator;
+						stepRe[i] = step.real();
+						stepIm[i] = step.imag();
+					}
+				}
+			});
+
+			remaining = 0;
+
+			for (std::size_t i = 0; i < n; i++)
+			{
+				if (done[i])
+				{
+					continue;
+				}
+
+				re[i] -= stepRe[i];
+				im[i] -= stepIm[i];
+
+				const auto size = std::max(R(1), std::hypot(re[i], im[i]));
+				if (std::hypot(stepRe[i], stepIm[i]) <= tolerance * size)
+				{
+					done[i] = 1;
+				}
+				else
+				{
+					remaining++;
+				}
+			}
+		}
+
+		for (std::size_t i = 0; i < n; i++)
+		{
+			roots[i] = std::complex<R>(re[i], im[i]);
+		}
+
+		converged = remaining == 0;
+
+		return iteration;
+	}
+
+	/*
+		Clenshaw evaluation of the Chebyshev series sum c[k] T_k(t), the analogue of Horner for the Chebyshev basis.
+		Runs b_k = 2t b_(k+1) - b_(k+2) + c[k] down to k = 0, and the value is b_0 - t b_1.
+	*/
+	template <typename C> C Clenshaw(const C* coefficients, const std::size_t count, const C t)
+	{
+		const C t2 = t + t;
+		C b1 = 0;
+		C b2 = 0;
+
+		for (auto k = count; k > 0; k--)
+		{
+			const C b0 = t2 * b1 - b2 + coefficients[k - 1];
+			b2 = b1;
+			b1 = b0;
+		}
+
+		return b1 - t * b2;
+	}
+
+	/*
+		Evaluates a Chebyshev series at n points x, mapped to t = x * scale + shift.
+		Generic version, used for long double and on processors without AVX2. Clenshaw is run on 8 points at a time, like EvaluateBatch.
+	*/
+	template <typename C> void ClenshawBatch(const C* coefficients, const std::size_t count, const C scale, const C shift,
+		const C* x, C* out, const std::size_t n)
+	{
+		const std::size_t lanes = 8;
+		std::size_t j = 0;
+
+		for (; j + lanes <= n; j += lanes)
+		{
+			C t2[lanes];
+			C b1[lanes] = {};
+			C b2[lanes] = {};
+
+			for (std::size_t l = 0; l < lanes; l++)
+			{
+				t2[l] = 2 * (x[j + l] * scale + shift);
+			}
+
+			for (auto k = count; k > 0; k--)
+			{
+				const C c = coefficients[k - 1];
+
+				for (std::size_t l = 0; l < lanes; l++)
+				{
+					const C b0 = t2[l] * b1[l] - b2[l] + c;
+					b2[l] = b1[l];
+					b1[l] = b0;
+				}
+			}
+
+			for (std::size_t l = 0; l < lanes; l++)
+			{
+				out[j + l] = b1[l] - t2[l] / 2 * b2[l];
+			}
+		}
+
+		//Remaining points
+		for (; j < n; j++)
+		{
+			out[j] = Clenshaw(coefficients, count, x[j] * scale + shift);
+		}
+	}
+
+	//Writes the n Chebyshev points of the first kind, cos(pi * (j + 1/2) / n), in decreasing order
+	template <typename C> void ChebyshevPoints(C* out, const std::size_t n)
+	{
+		typedef typename FftScalar<C>::Type F;
+		const F pi = std::acos(F(-1));
+
+		for (std::size_t j = 0; j < n; j++)
+		{
+			out[j] = static_cast<C>(std::cos(pi * (2 * j + 1) / (2 * n)));
+		}
+	}
+
+	/*
+		Chebyshev coefficients of the series of n terms through values at the n Chebyshev points, a DCT-II.
+		n must be a power of two. The DCT is an FFT of twice the size over the even extension of the values,
+		O(n log n), where the sum over the points would be O(n^2).
+	*/
+	template <typename C> void ChebyshevFromValues(const C* values, const std::size_t n, C* out, Executor& executor)
+	{
+		typedef typename FftScalar<C>::Type F;
+
+		if (n == 0)
+		{
+			return;
+		}
+
+		const auto size = 2 * n;
+		auto data = std::vector<std::complex<F>>(size);
+		for (std::size_t j = 0; j < n; j++)
+		{
+			data[j] = F(values[j]);
+			data[size - 1 - j] = F(values[j]);
+		}
+
+		Fft(data, FftRoots<F>(size), false, executor);
+
+		//Twice the cosine sum is the transform turned by a quarter sample, and c[0] has half the weight
+		const F pi = std::acos(F(-1));
+		for (std::size_t k = 0; k < n; k++)
+		{
+			const F angle = pi * k / size;
+			const F sum = data[k].real() * std::cos(angle) - data[k].imag() * std::sin(angle);
+
+			out[k] = static_cast<C>(sum / (k == 0 ? 2 * F(n) : F(n)));
+		}
+	}
+
+	/*
+		Monomial coefficients of the Chebyshev series of n terms, writing n coefficients to out.
+		Builds T_k by T_(k+1) = 2t T_k - T_(k-1), O(n^2) in loops that vectorize.
+	*/
+	template <typename C> void ChebyshevToMonomial(const C* coefficients, const std::size_t n, C* out)
+	{
+		std::fill(out, out + n, C(0));
+
+		if (n == 0)
+		{
+			return;
+		}
+
+		auto previous = std::vector<C>(n, C(0));
+		auto current = std::vector<C>(n, C(0));
+		previous[0] = 1;
+		out[0] = coefficients[0];
+
+		if (n > 1)
+		{
+			current[1] = 1;
+			out[1] = coefficients[1];
+		}
+
+		for (std::size_t k = 2; k < n; k++)
+		{
+			//T_k replaces T_(k-2), which is only needed for this step
+			previous[0] = -previous[0];
+			for (std::size_t i = 1; i <= k; i++)
+			{
+				previous[i] = 2 * current[i - 1] - previous[i];
+			}
+
+			std::swap(previous, current);
+
+			const C c = coefficients[k];
+			for (std::size_t i = 0; i <= k; i++)
+			{
+				out[i] += c * current[i];
+			}
+		}
+	}
+
+	/*
+		Chebyshev coefficients of the monomial series of n terms, writing n coefficients to out.
+		Horner in the Chebyshev basis, with x T_0 = T_1 and x T_k = (T_(k+1) + T_(k-1)) / 2, O(n^2).
+	*/
+	template <typename C> void MonomialToChebyshev(const C* coefficients, const std::size_t n, C* out)
+	{
+		std::fill(out, out + n, C(0));
+
+		if (n == 0)
+		{
+			return;
+		}
+
+		auto next = std::vector<C>(n, C(0));
+		out[0] = coefficients[n - 1];
+
+		for (auto i = n - 1; i > 0; i--)
+		{
+			//out holds n - i terms, x out one more
+			const auto terms = n - i;
+			std::fill(next.begin(), next.begin() + terms + 1, C(0));
+			next[1] = out[0];
+
+			for (std::size_t k = 1; k < terms; k++)
+			{
+				next[k + 1] += out[k] / 2;
+				next[k - 1] += out[k] / 2;
+			}
+
+			next[0] += coefficients[i - 1];
+			std::copy(next.begin(), next.begin() + terms + 1, out);
+		}
+	}
+
+	//Product of two Chebyshev series, by T_i T_j = (T_(i+j) + T_|i-j|) / 2, as a convolution and a correlation
+	template <typename C> std::vector<C> ChebyshevProduct(const std::vector<C>& a, const std::vector<C>& b, const Multiplier& multiply)
+	{
+		auto res = multiply(a, b);
+		const auto correlation = multiply(a, std::vector<C>(b.rbegin(), b.rend()));
+
+		for (auto& c : res)
+		{
+			c /= 2;
+		}
+
+		//correlation[d] collects the products with i - j = d - (b.size() - 1)
+		for (std::size_t d = 0; d < correlation.size(); d++)
+		{
+			const auto k = d + 1 >= b.size() ? d + 1 - b.size() : b.size() - 1 - d;
+			res[k] += correlation[d] / 2;
+		}
+
+		return res;
+	}
+
+	//Number of coefficients converted in O(n^2) at the leaves of the basis change recursions
+	const std::size_t chebyshevLeafSize = 32;
+
+	/*
+		Chebyshev coefficients of the n monomial coefficients from p, given powers[k], the Chebyshev series
+		of x^(chebyshevLeafSize * 2^k). Splits p = low + x^h high, like ComposeRange.
+	*/
+	template <typename C> std::vector<C> MonomialToChebyshevRange(const C* p, const std::size_t n,
+		const std::vector<std::vector<C>>& powers, const std::size_t level, const Multiplier& multiply)
+	{
+		if (level == 0)
+		{
+			auto res = std::vector<C>(n);
+			MonomialToChebyshev(p, n, res.data());
+
+			return res;
+		}
+
+		const auto h = chebyshevLeafSize << (level - 1);
+
+		if (n <= h)
+		{
+			return MonomialToChebyshevRange(p, n, powers, level - 1, multiply);
+		}
+
+		auto res = MonomialToChebyshevRange(p, h, powers, level - 1, multiply);
+		auto high = ChebyshevProduct(MonomialToChebyshevRange(p + h, n - h, powers, level - 1, multiply), powers[level - 1], multiply);
+
+		res.resize(std::max(res.size(), high.size()), C(0));
+		for (std::size_t i = 0; i < high.size(); i++)
+		{
+			res[i] += high[i];
+		}
+
+		res.resize(n);
+
+		return res;
+	}
+
+	/*
+		Monomial coefficients of the Chebyshev series c of n terms, given powers[k], the monomial coefficients
+		of T_h for h = chebyshevLeafSize * 2^k. With T_(h+j) = 2 T_h T_j - T_(h-j), the terms from h on give
+		2 T_h S - c_h T_h - R, for S = sum c_(h+j) T_j and R = sum c_(h+j) T_(h-j) over j > 0, which folds into the low terms.
+	*/
+	template <typename C> std::vector<C> ChebyshevToMonomialRange(const C* c, const std::size_t n,
+		const std::vector<std::vector<C>>& powers, const std::size_t level, const Multiplier& multiply)
+	{
+		if (level == 0)
+		{
+			auto res = std::vector<C>(n);
+			ChebyshevToMonomial(c, n, res.data());
+
+			return res;
+		}
+
+		const auto h = chebyshevLeafSize << (level - 1);
+
+		if (n <= h)
+		{
+			return ChebyshevToMonomialRange(c, n, powers, level - 1, multiply);
+		}
+
+		//n <= 2h, so R only reaches the low terms
+		auto low = std::vector<C>(c, c + h);
+		for (auto j = n - h; j-- > 1;)
+		{
+			low[h - j] -= c[h + j];
+		}
+
+		auto high = ChebyshevToMonomialRange(c + h, n - h, powers, level - 1, multiply);
+		for (auto& x : high)
+		{
+			x *= 2;
+		}
+		high[0] -= c[h];
+
+		auto res = ChebyshevToMonomialRange(low.data(), h, powers, level - 1, multiply);
+		auto product = multiply(high, powers[level - 1]);
+
+		res.resize(std::max(res.size(), product.size()), C(0));
+		for (std::size_t i = 0; i < product.size(); i++)
+		{
+			res[i] += product[i];
+		}
+
+		res.resize(n);
+
+		return res;
+	}
+
+	/*
+		Changes between the monomial and the Chebyshev basis by divide and conquer on top of fast multiplication,
+		O(M(n) log n) for multiplication cost M, and O(n^2) below chebyshevLeafSize. Powers of the split point
+		are squared up from the leaf size, with T_2h = 2 T_h^2 - 1 in the monomial direction.
+	*/
+	template <typename C> std::vector<C> MonomialToChebyshev(const C* p, const std::size_t n, const Multiplier& multiply)
+	{
+		auto powers = std::vector<std::vector<C>>();
+		std::size_t level = 0;
+
+		if (n > chebyshevLeafSize)
+		{
+			auto monomial = std::vector<C>(chebyshevLeafSize + 1, C(0));
+			monomial.back() = 1;
+
+			auto power = std::vector<C>(chebyshevLeafSize + 1);
+			MonomialToChebyshev(monomial.data(), monomial.size(), power.data());
+
+			powers.push_back(std::move(power));
+			level = 1;
+
+			while ((chebyshevLeafSize << level) < n)
+			{
+				powers.push_back(ChebyshevProduct(powers.back(), powers.back(), multiply));
+				level++;
+			}
+		}
+
+		return MonomialToChebyshevRange(p, n, powers, level, multiply);
+	}
+
+	template <typename C> std::vector<C> ChebyshevToMonomial(const C* c, const std::size_t n, const Multiplier& multiply)
+	{
+		auto powers = std::vector<std::vector<C>>();
+		std::size_t level = 0;
+
+		if (n > chebyshevLeafSize)
+		{
+			auto chebyshev = std::vector<C>(chebyshevLeafSize + 1, C(0));
+			chebyshev.back() = 1;
+
+			auto power = std::vector<C>(chebyshevLeafSize + 1);
+			ChebyshevToMonomial(chebyshev.data(), chebyshev.size(), power.data());
+
+			powers.push_back(std::move(power));
+			level = 1;
+
+			while ((chebyshevLeafSize << level) < n)
+			{
+				auto square = multiply(powers.back(), powers.back());
+				for (auto& x : square)
+				{
+					x *= 2;
+				}
+				square[0] -= 1;
+
+				powers.push_back(std::move(square));
+				level++;
+			}
+		}
+
+		return ChebyshevToMonomialRange(c, n, powers, level, multiply);
+	}
+
+	//Derivative of a Chebyshev series in t, writing count - 1 coefficients to out, by d_(k-1) = d_(k+1) + 2k c_k
+	template <typename C> void ChebyshevDerivative(const C* coefficients, const std::size_t count, C* out)
+	{
+		if (count < 2)
+		{
+			return;
+		}
+
+		for (auto k = count - 1; k > 0; k--)
+		{
+			out[k - 1] = (k + 1 < count - 1 ? out[k + 1] : C(0)) + 2 * static_cast<C>(k) * coefficients[k];
+		}
+
+		out[0] /= 2;
+	}
+
+	/*
+		Antiderivative of a Chebyshev series in t, writing count + 1 coefficients to out,
+		by C_k = (c_(k-1) - c_(k+1)) / 2k with c_0 counted twice. The constant makes it 0 at t = -1.
+	*/
+	template <typename C> void ChebyshevIntegrate(const C* coefficients, const std::size_t count, C* out)
+	{
+		C constant = 0;
+
+		for (std::size_t k = 1; k <= count; k++)
+		{
+			const C low = k == 1 ? 2 * coefficients[0] : coefficients[k - 1];
+			const C high = k + 1 < count ? coefficients[k + 1] : C(0);
+
+			out[k] = (low - high) / (2 * static_cast<C>(k));
+
+			//T_k(-1) = (-1)^k
+			constant += k % 2 == 0 ? -out[k] : out[k];
+		}
+
+		out[0] = constant;
+	}
+
+#if defined(POLYNOMIAL_SIMD_AVX2_DISPATCH)
+#pragma GCC push_options
+#pragma GCC target("avx2,fma")
+#endif
+
+#if defined(POLYNOMIAL_SIMD_AVX512) || defined(POLYNOMIAL_SIMD_AVX2_DISPATCH)
+	/*
+		SIMD Horner, running 4 vector registers of points at once to hide the FMA latency.
+		V describes the vector type, see the traits below. The last points are padded to a full step,
+		so every point rounds the same way wherever a batch is split.
+	*/
+	template <typename V> void SimdEvaluateBatch(const typename V::Scalar* coefficients, const std::size_t count,
+		const typename V::Scalar* x, typename V::Scalar* out, const std::size_t n)
+	{
+		typedef typename V::Scalar S;
+
+		const std::size_t step = 4 * V::width;
+
+		for (std::size_t j = 0; j < n; j += step)
+		{
+			S paddedX[4 * V::width] = {};
+			S paddedOut[4 * V::width];
+			const auto partial = j + step > n;
+
+			const S* xj = x + j;
+			S* oj = out + j;
+			if (partial)
+			{
+				std::copy(x + j, x + n, paddedX);
+				xj = paddedX;
+				oj = paddedOut;
+			}
+
+			auto x0 = V::Load(xj);
+			auto x1 = V::Load(xj + V::width);
+			auto x2 = V::Load(xj + 2 * V::width);
+			auto x3 = V::Load(xj + 3 * V::width);
+
+			auto a0 = V::Zero();
+			auto a1 = V::Zero();
+			auto a2 = V::Zero();
+			auto a3 = V::Zero();
+
+			for (auto i = count; i > 0; i--)
+			{
+				auto c = V::Broadcast(coefficients[i - 1]);
+
+				a0 = V::MulAdd(a0, x0, c);
+				a1 = V::MulAdd(a1, x1, c);
+				a2 = V::MulAdd(a2, x2, c);
+				a3 = V::MulAdd(a3, x3, c);
+			}
+
+			V::Store(oj, a0);
+			V::Store(oj + V::width, a1);
+			V::Store(oj + 2 * V::width, a2);
+			V::Store(oj + 3 * V::width, a3);
+
+			if (partial)
+			{
+				std::copy(paddedOut, paddedOut + (n - j), out + j);
+			}
+		}
+	}
+
+	/*
+		SIMD Clenshaw, running 4 vector registers of points at once like SimdEvaluateBatch.
+		Only 2t is kept in a register, and the value b_0 - t b_1 is taken as b_0 + (2t * -1/2) b_1.
+	*/
+	template <typename V> void SimdClenshawBatch(const typename V::Scalar* coefficients, const std::size_t count,
+		const typename V::Scalar scale, const typename V::Scalar shift,
+		const typename V::Scalar* x, typename V::Scalar* out, const std::size_t n)
+	{
+		typedef typename V::Scalar S;
+
+		const std::size_t step = 4 * V::width;
+		const auto scale2 = V::Broadcast(2 * scale);
+		const auto shift2 = V::Broadcast(2 * shift);
+		const auto minusHalf = V::Broadcast(S(-0.5));
+
+		for (std::size_t j = 0; j < n; j += step)
+		{
+			S paddedX[4 * V::width] = {};
+			S paddedOut[4 * V::width];
+			const auto partial = j + step > n;
+
+			const S* xj = x + j;
+			S* oj = out + j;
+			if (partial)
+			{
+				std::copy(x + j, x + n, paddedX);
+				xj = paddedX;
+				oj = paddedOut;
+			}
+
+			auto t0 = V::MulAdd(V::Load(xj), scale2, shift2);
+			auto t1 = V::MulAdd(V::Load(xj + V::width), scale2, shift2);
+			auto t2 = V::MulAdd(V::Load(xj + 2 * V::width), scale2, shift2);
+			auto t3 = V::MulAdd(V::Load(xj + 3 * V::width), scale2, shift2);
+
+			auto b0 = V::Zero();
+			auto b1 = V::Zero();
+			auto b2 = V::Zero();
+			auto b3 = V::Zero();
+			auto p0 = V::Zero();
+			auto p1 = V::Zero();
+			auto p2 = V::Zero();
+			auto p3 = V::Zero();
+
+			for (auto k = count; k > 0; k--)
+			{
+				auto c = V::Broadcast(coefficients[k - 1]);
+
+				auto n0 = V::MulAdd(t0, b0, V::Sub(c, p0));
+				auto n1 = V::MulAdd(t1, b1, V::Sub(c, p1));
+				auto n2 = V::MulAdd(t2, b2, V::Sub(c, p2));
+				auto n3 = V::MulAdd(t3, b3, V::Sub(c, p3));
+
+				p0 = b0;
+				p1 = b1;
+				p2 = b2;
+				p3 = b3;
+				b0 = n0;
+				b1 = n1;
+				b2 = n2;
+				b3 = n3;
+			}
+
+			V::Store(oj, V::MulAdd(V::MulAdd(t0, minusHalf, V::Zero()), p0, b0));
+			V::Store(oj + V::width, V::MulAdd(V::MulAdd(t1, minusHalf, V::Zero()), p1, b1));
+			V::Store(oj + 2 * V::width, V::MulAdd(V::MulAdd(t2, minusHalf, V::Zero()), p2, b2));
+			V::Store(oj + 3 * V::width, V::MulAdd(V::MulAdd(t3, minusHalf, V::Zero()), p3, b3));
+
+			if (partial)
+			{
+				std::copy(paddedOut, paddedOut + (n - j), out + j);
+			}
+		}
+	}
+#endif
+
+#if defined(POLYNOMIAL_SIMD_AVX512)
+	struct Avx512Double
+	{
+		typedef double Scalar;
+		static const std::size_t width = 8;
+
+		static __m512d Load(const double* p) { return _mm512_loadu_pd(p); }
+		static void Store(double* p, __m512d v) { _mm512_storeu_pd(p, v); }
+		static __m512d Zero() { return _mm512_setzero_pd(); }
+		static __m512d Broadcast(const double c) { return _mm512_set1_pd(c); }
+		static __m512d MulAdd(__m512d a, __m512d b, __m512d c) { return _mm512_fmadd_pd(a, b, c); }
+		static __m512d Sub(__m512d a, __m512d b) { return _mm512_sub_pd(a, b); }
+	};
+
+	struct Avx512Float
+	{
+		typedef float Scalar;
+		static const std::size_t width = 16;
+
+		static __m512 Load(const float* p) { return _mm512_loadu_ps(p); }
+		static void Store(float* p, __m512 v) { _mm512_storeu_ps(p, v); }
+		static __m512 Zero() { return _mm512_setzero_ps(); }
+		static __m512 Broadcast(const float c) { return _mm512_set1_ps(c); }
+		static __m512 MulAdd(__m512 a, __m512 b, __m512 c) { return _mm512_fmadd_ps(a, b, c); }
+		static __m512 Sub(__m512 a, __m512 b) { return _mm512_sub_ps(a, b); }
+	};
+
+	inline void EvaluateBatch(const double* coefficients, const std::size_t count, const double* x, double* out, const std::size_t n)
+	{
+		SimdEvaluateBatch<Avx512Double>(coefficients, count, x, out, n);
+	}
+
+	inline void ClenshawBatch(const double* coefficients, const std::size_t count, const double scale, const double shift,
+		const double* x, double* out, const std::size_t n)
+	{
+		SimdClenshawBatch<Avx512Double>(coefficients, count, scale, shift, x, out, n);
+	}
+
+	inline void EvaluateBatch(const float* coefficients, const std::size_t count, const float* x, float* out, const std::size_t n)
+	{
+		SimdEvaluateBatch<Avx512Float>(coefficients, count, x, out, n);
+	}
+
+	inline void ClenshawBatch(const float* coefficients, const std::size_t count, const float scale, const float shift,
+		const float* x, float* out, const std::size_t n)
+	{
+		SimdClenshawBatch<Avx512Float>(coefficients, count, scale, shift, x, out, n);
+	}
+#elif defined(POLYNOMIAL_SIMD_AVX2_DISPATCH)
+	struct Avx2Double
+	{
+		typedef double Scalar;
+		static const std::size_t width = 4;
+
+		static __m256d Load(const double* p) { return _mm256_loadu_pd(p); }
+		static void Store(double* p, __m256d v) { _mm256_storeu_pd(p, v); }
+		static __m256d Zero() { return _mm256_setzero_pd(); }
+		static __m256d Broadcast(const double c) { return _mm256_set1_pd(c); }
+		static __m256d MulAdd(__m256d a, __m256d b, __m256d c) { return _mm256_fmadd_pd(a, b, c); }
+		static __m256d Sub(__m256d a, __m256d b) { return _mm256_sub_pd(a, b); }
+	};
+
+	struct Avx2Float
+	{
+		typedef float Scalar;
+		static const std::size_t width = 8;
+
+		static __m256 Load(const float* p) { return _mm256_loadu_ps(p); }
+		static void Store(float* p, __m256 v) { _mm256_storeu_ps(p, v); }
+		static __m256 Zero() { return _mm256_setzero_ps(); }
+		static __m256 Broadcast(const float c) { return _mm256_set1_ps(c); }
+		static __m256 MulAdd(__m256 a, __m256 b, __m256 c) { return _mm256_fmadd_ps(a, b, c); }
+		static __m256 Sub(__m256 a, __m256 b) { return _mm256_sub_ps(a, b); }
+	};
+
+	//Entry points compiled for AVX2 and FMA, only called when the processor has them
+	inline void EvaluateBatchAvx2(const double* coefficients, const std::size_t count, const double* x, double* out, const std::size_t n)
+	{
+		SimdEvaluateBatch<Avx2Double>(coefficients, count, x, out, n);
+	}
+
+	inline void ClenshawBatchAvx2(const double* coefficients, const std::size_t count, const double scale, const double shift,
+		const double* x, double* out, const std::size_t n)
+	{
+		SimdClenshawBatch<Avx2Double>(coefficients, count, scale, shift, x, out, n);
+	}
+
+	inline void EvaluateBatchAvx2(const float* coefficients, const std::size_t count, const float* x, float* out, const std::size_t n)
+	{
+		SimdEvaluateBatch<Avx2Float>(coefficients, count, x, out, n);
+	}
+
+	inline void ClenshawBatchAvx2(const float* coefficients, const std::size_t count, const float scale, const float shift,
+		const float* x, float* out, const std::size_t n)
+	{
+		SimdClenshawBatch<Avx2Float>(coefficients, count, scale, shift, x, out, n);
+	}
+
+#pragma GCC pop_options
+
+	//Whether the processor runs AVX2 and FMA, checked once
+	inline bool HasAvx2()
+	{
+		static const bool supported = __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+
+		return supported;
+	}
+
+	inline void EvaluateBatch(const double* coefficients, const std::size_t count, const double* x, double* out, const std::size_t n)
+	{
+		if (HasAvx2())
+		{
+			EvaluateBatchAvx2(coefficients, count, x, out, n);
+		}
+		else
+		{
+			EvaluateBatch<double>(coefficients, count, x, out, n);
+		}
+	}
+
+	inline void ClenshawBatch(const double* coefficients, const std::size_t count, const double scale, const double shift,
+		const double* x, double* out, const std::size_t n)
+	{
+		if (HasAvx2())
+		{
+			ClenshawBatchAvx2(coefficients, count, scale, shift, x, out, n);
+		}
+		else
+		{
+			ClenshawBatch<double>(coefficients, count, scale, shift, x, out, n);
+		}
+	}
+
+	inline void EvaluateBatch(const float* coefficients, const std::size_t count, const float* x, float* out, const std::size_t n)
+	{
+		if (HasAvx2())
+		{
+			EvaluateBatchAvx2(coefficients, count, x, out, n);
+		}
+		else
+		{
+			EvaluateBatch<float>(coefficients, count, x, out, n);
+		}
+	}
+
+	inline void ClenshawBatch(const float* coefficients, const std::size_t count, const float scale, const float shift,
+		const float* x, float* out, const std::size_t n)
+	{
+		if (HasAvx2())
+		{
+			ClenshawBatchAvx2(coefficients, count, scale, shift, x, out, n);
+		}
+		else
+		{
+			ClenshawBatch<float>(coefficients, count, scale, shift, x, out, n);
+		}
+	}
+#endif
+}
+
+#endif
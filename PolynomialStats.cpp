@@ -0,0 +1,144 @@
+/*
+	Name: 			Michael Lausdahl Fuglsang
+	email:			mfugls11
+	Study No.:		20112699
+
+	Code also available at:
+	https://github.com/Malakahh/Ap-exam-part-2
+*/
+
+#include "PolynomialStats.h"
+
+#include <mutex>
+#include <vector>
+#include <algorithm>
+
+using PolynomialInstrumentation::ThreadCounters;
+
+namespace
+{
+	const std::size_t counterCount = static_cast<std::size_t>(PolynomialCounter::Count);
+
+	struct Registry
+	{
+		std::mutex mutex;
+		std::vector<ThreadCounters*> threads;
+
+		//Counts of threads that have exited
+		std::size_t retired[counterCount] = {};
+
+		//Totals at the last ResetPolynomialStats, which doesn't write the counters of other threads
+		std::size_t baseline[counterCount] = {};
+	};
+
+	//Never destroyed, as threads may exit after static destruction
+	Registry& GetRegistry()
+	{
+		static auto registry = new Registry();
+		return *registry;
+	}
+
+	//Sums all threads, with the registry locked
+	void Totals(Registry& registry, std::size_t* totals)
+	{
+		std::copy(registry.retired, registry.retired + counterCount, totals);
+
+		for (auto counters : registry.threads)
+		{
+			for (std::size_t i = 0; i < counterCount; i++)
+			{
+				totals[i] += counters->values[i].load(std::memory_order_relaxed);
+			}
+		}
+	}
+
+	//Moves the counts of a thread to the retired counts when it exits
+	struct ThreadExit
+	{
+		~ThreadExit()
+		{
+			auto counters = PolynomialInstrumentation::LocalCounters();
+			auto& registry = GetRegistry();
+
+			{
+				std::lock_guard<std::mutex> lock(registry.mutex);
+
+				for (std::size_t i = 0; i < counterCount; i++)
+				{
+					registry.retired[i] += counters->values[i].load(std::memory_order_relaxed);
+				}
+
+				registry.threads.erase(std::find(registry.threads.begin(), registry.threads.end(), counters));
+			}
+
+			PolynomialInstrumentation::LocalCounters() = nullptr;
+			delete counters;
+		}
+	};
+}
+
+namespace PolynomialInstrumentation
+{
+	ThreadCounters* RegisterThread()
+	{
+		auto counters = new ThreadCounters();
+		auto& registry = GetRegistry();
+
+		{
+			std::lock_guard<std::mutex> lock(registry.mutex);
+			registry.threads.push_back(counters);
+		}
+
+		LocalCounters() = counters;
+
+		//Constructed on the first count of the thread, and destroyed when it exits
+		static thread_local ThreadExit threadExit;
+		(void)threadExit;
+
+		return counters;
+	}
+}
+
+PolynomialStats GetPolynomialStats()
+{
+	std::size_t totals[counterCount];
+	auto& registry = GetRegistry();
+
+	{
+		std::lock_guard<std::mutex> lock(registry.mutex);
+		Totals(registry, totals);
+
+		for (std::size_t i = 0; i < counterCount; i++)
+		{
+			totals[i] -= registry.baseline[i];
+		}
+	}
+
+	auto get = [&](const PolynomialCounter counter) { return totals[static_cast<std::size_t>(counter)]; };
+
+	PolynomialStats stats;
+
+	stats.integralCacheHits = get(PolynomialCounter::IntegralCacheHits);
+	stats.integralCacheMisses = get(PolynomialCounter::IntegralCacheMisses);
+	stats.lockWaits = get(PolynomialCounter::LockWaits);
+	stats.allocations = get(PolynomialCounter::Allocations);
+	stats.schoolbookMultiplications = get(PolynomialCounter::SchoolbookMultiplications);
+	stats.karatsubaMultiplications = get(PolynomialCounter::KaratsubaMultiplications);
+	stats.fftMultiplications = get(PolynomialCounter::FftMultiplications);
+	stats.nttMultiplications = get(PolynomialCounter::NttMultiplications);
+	stats.sparseMultiplications = get(PolynomialCounter::SparseMultiplications);
+	stats.evaluations = get(PolynomialCounter::Evaluations);
+	stats.batchEvaluations = get(PolynomialCounter::BatchEvaluations);
+	stats.evaluatedPoints = get(PolynomialCounter::EvaluatedPoints);
+	stats.multipointEvaluations = get(PolynomialCounter::MultipointEvaluations);
+
+	return stats;
+}
+
+void ResetPolynomialStats()
+{
+	auto& registry = GetRegistry();
+
+	std::lock_guard<std::mutex> lock(registry.mutex);
+	Totals(registry, registry.baseline);
+}
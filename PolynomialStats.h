@@ -0,0 +1,125 @@
+/*
+	Name: 			Michael Lausdahl Fuglsang
+	email:			mfugls11
+	Study No.:		20112699
+
+	Code also available at:
+	https://github.com/Malakahh/Ap-exam-part-2
+*/
+
+#ifndef _POLYNOMIAL_STATS
+#define _POLYNOMIAL_STATS
+
+#include <cstddef>
+#include <atomic>
+
+/*
+	Instrumentation counters for the Polynomial hot paths, shared by all coefficient types.
+	Every thread counts into counters of its own, with a plain load and store instead of a locked increment,
+	so the read paths don't share a written cache line between threads. GetPolynomialStats sums the threads.
+	Define POLYNOMIAL_NO_STATS for all translation units to compile the counting out, the getters then return zeros.
+*/
+enum class PolynomialCounter : std::size_t
+{
+	IntegralCacheHits,
+	IntegralCacheMisses,
+	LockWaits,
+	Allocations,
+	SchoolbookMultiplications,
+	KaratsubaMultiplications,
+	FftMultiplications,
+	NttMultiplications,
+	SparseMultiplications,
+	Evaluations,
+	BatchEvaluations,
+	EvaluatedPoints,
+	MultipointEvaluations,
+	Count
+};
+
+/*
+	Snapshot of the counters.
+*/
+struct PolynomialStats
+{
+	//Integrals served from the antiderivative cache, and integrals that had to build it
+	std::size_t integralCacheHits;
+	std::size_t integralCacheMisses;
+
+	//Times a thread found a polynomial locked and had to wait for it
+	std::size_t lockWaits;
+
+	//Heap allocations of coefficient buffers
+	std::size_t allocations;
+
+	//Multiplications by the algorithm chosen for them
+	std::size_t schoolbookMultiplications;
+	std::size_t karatsubaMultiplications;
+	std::size_t fftMultiplications;
+	std::size_t nttMultiplications;
+	std::size_t sparseMultiplications;
+
+	//Calls to ValueAt and ValueAtRange, the points evaluated by the latter, and how often it used a remainder tree
+	std::size_t evaluations;
+	std::size_t batchEvaluations;
+	std::size_t evaluatedPoints;
+	std::size_t multipointEvaluations;
+};
+
+//Whether this build counts anything.
+#ifdef POLYNOMIAL_NO_STATS
+const bool polynomialStatsEnabled = false;
+#else
+const bool polynomialStatsEnabled = true;
+#endif
+
+//Gets the current value of all counters.
+PolynomialStats GetPolynomialStats();
+
+//Sets all counters to 0.
+void ResetPolynomialStats();
+
+namespace PolynomialInstrumentation
+{
+	/*
+		Counters of a single thread. Only the owning thread writes them, other threads read them for GetPolynomialStats.
+		Padded so the counters of two threads never share a cache line.
+	*/
+	struct ThreadCounters
+	{
+		char before[64];
+		std::atomic<std::size_t> values[static_cast<std::size_t>(PolynomialCounter::Count)];
+		char after[64];
+	};
+
+	//Creates the counters of the calling thread and registers them for GetPolynomialStats.
+	ThreadCounters* RegisterThread();
+
+	//Counters of the calling thread, nullptr until it first counts
+	inline ThreadCounters*& LocalCounters()
+	{
+		static thread_local ThreadCounters* counters = nullptr;
+		return counters;
+	}
+
+	//Adds to a counter of the calling thread.
+	inline void Count(const PolynomialCounter counter, const std::size_t amount = 1)
+	{
+#ifndef POLYNOMIAL_NO_STATS
+		auto counters = LocalCounters();
+		if (counters == nullptr)
+		{
+			counters = RegisterThread();
+		}
+
+		//No other thread writes the counter, so it needs no atomic read-modify-write
+		auto& value = counters->values[static_cast<std::size_t>(counter)];
+		value.store(value.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+#else
+		(void)counter;
+		(void)amount;
+#endif
+	}
+}
+
+#endif
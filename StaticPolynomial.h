@@ -0,0 +1,208 @@
+/*
+	Name: 			Michael Lausdahl Fuglsang
+	email:			mfugls11
+	Study No.:		20112699
+
+	Code also available at:
+	https://github.com/Malakahh/Ap-exam-part-2
+*/
+
+#ifndef _STATIC_POLYNOMIAL
+#define _STATIC_POLYNOMIAL
+
+#include <array>
+#include <utility>
+#include <stdexcept>
+#include <type_traits>
+#include <initializer_list>
+
+#include "Polynomial.h"
+
+/*
+	Polynomial with N coefficients, i.e. of degree N - 1, fixed at compile time.
+	Companion to Polynomial<C> for fits known at build time. Everything is constexpr,
+	evaluation is a fully unrolled Horner scheme, and derived polynomials get their
+	number of coefficients computed at compile time.
+*/
+template <typename C, std::size_t N> class StaticPolynomial
+{
+	static_assert(N > 0, "A StaticPolynomial needs at least one coefficient");
+
+private:
+	std::array<C, N> coefficients;
+
+	static constexpr bool AllConvertible(std::initializer_list<bool> convertible)
+	{
+		for (auto c : convertible)
+		{
+			if (!c)
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	//Horner from exponent I upwards, unrolled through overload resolution
+	template <std::size_t I> constexpr C HornerFrom(const C x, std::integral_constant<std::size_t, I>) const
+	{
+		return this->coefficients[I] + x * this->HornerFrom(x, std::integral_constant<std::size_t, I + 1>());
+	}
+
+	constexpr C HornerFrom(const C, std::integral_constant<std::size_t, N - 1>) const
+	{
+		return this->coefficients[N - 1];
+	}
+
+	constexpr C DerivativeCoefficient(const std::size_t exponent) const
+	{
+		return exponent + 1 < N ? this->coefficients[exponent + 1] * static_cast<C>(exponent + 1) : C(0);
+	}
+
+	constexpr C AntiderivativeCoefficient(const std::size_t exponent) const
+	{
+		return exponent == 0 ? C(0) : this->coefficients[exponent - 1] / static_cast<C>(exponent);
+	}
+
+	template <std::size_t M> constexpr C SumCoefficient(const StaticPolynomial<C, M>& rhs, const std::size_t exponent) const
+	{
+		return this->GetCoefficient(exponent) + rhs.GetCoefficient(exponent);
+	}
+
+	template <std::size_t M> constexpr C ProductCoefficient(const StaticPolynomial<C, M>& rhs, const std::size_t exponent) const
+	{
+		C sum = C(0);
+
+		for (std::size_t i = exponent + 1 > M ? exponent + 1 - M : 0; i <= exponent && i < N; i++)
+		{
+			sum += this->coefficients[i] * rhs.GetCoefficient(exponent - i);
+		}
+
+		return sum;
+	}
+
+	template <std::size_t... I> constexpr StaticPolynomial<C, sizeof...(I)> Derivative(std::index_sequence<I...>) const
+	{
+		return StaticPolynomial<C, sizeof...(I)>(std::array<C, sizeof...(I)>{ { this->DerivativeCoefficient(I)... } });
+	}
+
+	template <std::size_t... I> constexpr StaticPolynomial<C, sizeof...(I)> Antiderivative(std::index_sequence<I...>) const
+	{
+		return StaticPolynomial<C, sizeof...(I)>(std::array<C, sizeof...(I)>{ { this->AntiderivativeCoefficient(I)... } });
+	}
+
+	template <std::size_t M, std::size_t... I> constexpr StaticPolynomial<C, sizeof...(I)> Sum(const StaticPolynomial<C, M>& rhs, std::index_sequence<I...>) const
+	{
+		return StaticPolynomial<C, sizeof...(I)>(std::array<C, sizeof...(I)>{ { this->SumCoefficient(rhs, I)... } });
+	}
+
+	template <std::size_t M, std::size_t... I> constexpr StaticPolynomial<C, sizeof...(I)> Product(const StaticPolynomial<C, M>& rhs, std::index_sequence<I...>) const
+	{
+		return StaticPolynomial<C, sizeof...(I)>(std::array<C, sizeof...(I)>{ { this->ProductCoefficient(rhs, I)... } });
+	}
+
+public:
+	//Creates a polynomial with all coefficients 0.
+	constexpr StaticPolynomial() : coefficients() {}
+
+	//Creates a polynomial from its coefficients, lowest exponent first.
+	constexpr StaticPolynomial(const std::array<C, N>& coefficients) : coefficients(coefficients) {}
+
+	//Creates a polynomial from N coefficients, lowest exponent first.
+	template <typename... T, typename = typename std::enable_if<sizeof...(T) == N && AllConvertible({ std::is_convertible<T, C>::value... })>::type>
+	constexpr StaticPolynomial(const T... coefficients) : coefficients({ { static_cast<C>(coefficients)... } }) {}
+
+	/*
+		Copies the coefficients of a Polynomial.
+		Throws std::out_of_range if it has non-zero coefficients from exponent N.
+		A template only so that braced coefficient lists don't also match Polynomial's initializer list constructor.
+	*/
+	template <typename P, typename = typename std::enable_if<std::is_same<P, Polynomial<C>>::value>::type>
+	explicit StaticPolynomial(const P& p) : coefficients()
+	{
+		for (std::size_t i = 0; i < p.Size(); i++)
+		{
+			const auto c = p.GetCoefficient(static_cast<unsigned int>(i));
+
+			if (i < N)
+			{
+				this->coefficients[i] = c;
+			}
+			else if (c != C(0))
+			{
+				throw std::out_of_range("Polynomial has a higher degree than the StaticPolynomial can hold");
+			}
+		}
+	}
+
+	//Converts to a Polynomial with the same coefficients.
+	explicit operator Polynomial<C>() const
+	{
+		Polynomial<C> p(std::initializer_list<C>{});
+		p.template SetCoefficientRange<std::array<C, N>>(this->coefficients.begin(), this->coefficients.end());
+
+		return p;
+	}
+
+	//Gets a coefficient for a specific exponent, coefficients from exponent N are 0.
+	constexpr C GetCoefficient(const std::size_t exponent) const
+	{
+		return exponent < N ? this->coefficients[exponent] : C(0);
+	}
+
+	//Gets the highest exponent.
+	static constexpr std::size_t GetHighestCoefficient()
+	{
+		return N - 1;
+	}
+
+	//Valuates the polynomial at a given point.
+	constexpr C ValueAt(const C x) const
+	{
+		return this->HornerFrom(x, std::integral_constant<std::size_t, 0>());
+	}
+
+	//Valuates the polynomial at every point in [first, last), writing the results to out.
+	void ValueAtRange(const C* first, const C* last, C* out) const
+	{
+		for (; first != last; first++, out++)
+		{
+			*out = this->ValueAt(*first);
+		}
+	}
+
+	//Computes the derivative, a constant polynomial stays at one coefficient.
+	constexpr StaticPolynomial<C, (N > 1 ? N - 1 : 1)> CalculateDerivative() const
+	{
+		return this->Derivative(std::make_index_sequence<(N > 1 ? N - 1 : 1)>());
+	}
+
+	//Computes the antiderivative with a zero constant term.
+	constexpr StaticPolynomial<C, N + 1> CalculateAntiderivative() const
+	{
+		static_assert(!std::is_integral<C>::value, "Antiderivatives of integer polynomials can't be represented exactly");
+
+		return this->Antiderivative(std::make_index_sequence<N + 1>());
+	}
+
+	//Computes an integral for the given interval bounds.
+	constexpr C CalculateIntegral(const C a, const C b) const
+	{
+		return this->CalculateAntiderivative().ValueAt(b) - this->CalculateAntiderivative().ValueAt(a);
+	}
+
+	//Returns a polynomial equal to the sum of this and a given polynomial.
+	template <std::size_t M> constexpr StaticPolynomial<C, (N > M ? N : M)> operator+(const StaticPolynomial<C, M>& rhs) const
+	{
+		return this->Sum(rhs, std::make_index_sequence<(N > M ? N : M)>());
+	}
+
+	//Returns a polynomial equal to the product of this and a given polynomial.
+	template <std::size_t M> constexpr StaticPolynomial<C, N + M - 1> operator*(const StaticPolynomial<C, M>& rhs) const
+	{
+		return this->Product(rhs, std::make_index_sequence<N + M - 1>());
+	}
+};
+
+#endif
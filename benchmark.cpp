@@ -0,0 +1,401 @@
+/*
+	Name: 			Michael Lausdahl Fuglsang
+	email:			mfugls11
+	Study No.:		20112699
+
+	Code also available at:
+	https://github.com/Malakahh/Ap-exam-part-2
+*/
+
+/*
+	Microbenchmarks for the Polynomial operations.
+	Sweeps degree and batch size for int, float, double and long double, and writes one
+	row per measurement to stdout, as CSV by default or as JSON with --json.
+
+	Options:
+		--json		Write a JSON array instead of CSV.
+		--quick		Smaller sweep with shorter measurements, for smoke testing.
+		--inline	Run everything on the calling thread, using an InlineExecutor.
+		--filter=X	Only run operations whose name contains X.
+*/
+
+#include "Polynomial.h"
+#include "PolynomialBatch.h"
+#include "ChebyshevPolynomial.h"
+
+#include <chrono>
+#include <atomic>
+#include <vector>
+#include <string>
+#include <cstdlib>
+#include <cstdio>
+#include <cstring>
+#include <new>
+#include <type_traits>
+
+/*******
+******** 	Allocation counting
+********/
+
+std::atomic<std::size_t> allocationCount(0);
+
+/*
+	The replacements are not inlined, as GCC would otherwise see malloc and free paired with
+	operator delete and operator new where they meet, and warn of mismatched allocation functions.
+*/
+__attribute__((noinline)) void* operator new(std::size_t size)
+{
+	allocationCount.fetch_add(1, std::memory_order_relaxed);
+
+	if (void* p = std::malloc(size > 0 ? size : 1))
+	{
+		return p;
+	}
+
+	throw std::bad_alloc();
+}
+
+__attribute__((noinline)) void operator delete(void* p) noexcept
+{
+	std::free(p);
+}
+
+__attribute__((noinline)) void operator delete(void* p, std::size_t) noexcept
+{
+	std::free(p);
+}
+
+/*******
+******** 	Harness
+********/
+
+namespace
+{
+	struct Options
+	{
+		bool json = false;
+		bool quick = false;
+		bool inlineExecutor = false;
+		std::string filter;
+	};
+
+	struct Result
+	{
+		std::size_t iterations;
+		double nsPerOp;
+		double itemsPerSecond;
+		double allocationsPerOp;
+	};
+
+	Options options;
+	bool firstRow = true;
+
+	//Keeps results alive so the compiler can't drop the measured work
+	volatile long double sink;
+
+	template <typename C> const char* TypeName();
+	template <> const char* TypeName<int>() { return "int"; }
+	template <> const char* TypeName<float>() { return "float"; }
+	template <> const char* TypeName<double>() { return "double"; }
+	template <> const char* TypeName<long double>() { return "long double"; }
+
+	/*
+		Runs body in growing batches until a batch takes at least the minimum time,
+		then reports that batch. items is the number of results one call produces.
+	*/
+	template <typename F> Result Measure(const F& body, const std::size_t items)
+	{
+		typedef std::chrono::steady_clock Clock;
+
+		const auto minimum = std::chrono::milliseconds(options.quick ? 2 : 50);
+
+		//Warm up caches, thread pool and lazily built data
+		body();
+
+		std::size_t iterations = 1;
+
+		while (true)
+		{
+			const auto allocations = allocationCount.load(std::memory_order_relaxed);
+			const auto start = Clock::now();
+
+			for (std::size_t i = 0; i < iterations; i++)
+			{
+				body();
+			}
+
+			const auto elapsed = Clock::now() - start;
+			const auto allocated = allocationCount.load(std::memory_order_relaxed) - allocations;
+
+			if (elapsed >= minimum || iterations >= (std::size_t(1) << 30))
+			{
+				const auto ns = std::chrono::duration<double, std::nano>(elapsed).count() / iterations;
+
+				return { iterations, ns, items * 1e9 / ns, static_cast<double>(allocated) / iterations };
+			}
+
+			iterations *= 2;
+		}
+	}
+
+	void Report(const char* type, const char* operation, const std::size_t degree, const std::size_t batch, const Result& r)
+	{
+		if (options.json)
+		{
+			std::printf("%s\n  {\"type\": \"%s\", \"operation\": \"%s\", \"degree\": %zu, \"batch\": %zu, \"iterations\": %zu, "
+				"\"ns_per_op\": %.3f, \"items_per_second\": %.1f, \"allocations_per_op\": %.3f}",
+				firstRow ? "[" : ",", type, operation, degree, batch, r.iterations, r.nsPerOp, r.itemsPerSecond, r.allocationsPerOp);
+		}
+		else
+		{
+			if (firstRow)
+			{
+				std::printf("type,operation,degree,batch,iterations,ns_per_op,items_per_second,allocations_per_op\n");
+			}
+
+			std::printf("%s,%s,%zu,%zu,%zu,%.3f,%.1f,%.3f\n",
+				type, operation, degree, batch, r.iterations, r.nsPerOp, r.itemsPerSecond, r.allocationsPerOp);
+		}
+
+		firstRow = false;
+		std::fflush(stdout);
+	}
+
+	bool Enabled(const char* operation)
+	{
+		return options.filter.empty() || std::strstr(operation, options.filter.c_str()) != nullptr;
+	}
+
+	template <typename F> void Run(const char* type, const char* operation, const std::size_t degree, const std::size_t batch, const F& body)
+	{
+		if (Enabled(operation))
+		{
+			Report(type, operation, degree, batch, Measure(body, batch));
+		}
+	}
+
+	/*
+		Test data. Integer values stay within -1..1 so products and evaluations don't overflow,
+		floating point values are spread over [-1, 1].
+	*/
+	template <typename C> C Value(const std::size_t i)
+	{
+		return std::is_integral<C>::value ? static_cast<C>(static_cast<int>(i % 3) - 1)
+			: static_cast<C>(static_cast<double>((i * 7919) % 2001) / 1000 - 1);
+	}
+
+	template <typename C> Polynomial<C> MakePolynomial(const std::size_t degree)
+	{
+		Polynomial<C> p(std::initializer_list<C>{});
+
+		{
+			auto m = p.Mutate();
+			m.Resize(degree + 1);
+
+			for (std::size_t i = 0; i <= degree; i++)
+			{
+				m[i] = Value<C>(i + 1);
+			}
+
+			//Keep the polynomial dense and of full degree
+			m[degree] = C(1);
+		}
+
+		return p;
+	}
+
+	template <typename C> std::vector<C> MakePoints(const std::size_t count)
+	{
+		auto points = std::vector<C>(count);
+
+		for (std::size_t i = 0; i < count; i++)
+		{
+			points[i] = Value<C>(i * 13 + 5);
+		}
+
+		return points;
+	}
+
+	//Integrals are only defined for floating point coefficients
+	template <typename C> void RunIntegrals(const char*, const Polynomial<C>&, const std::size_t, const std::vector<std::size_t>&, std::true_type) {}
+
+	template <typename C> void RunIntegrals(const char* type, const Polynomial<C>& p, const std::size_t degree,
+		const std::vector<std::size_t>& batches, std::false_type)
+	{
+		Run(type, "CalculateIntegral", degree, 1, [&]() { sink = p.CalculateIntegral(C(-0.5), C(0.75)); });
+
+		for (auto batch : batches)
+		{
+			auto a = MakePoints<C>(batch);
+			auto b = MakePoints<C>(batch + 1);
+			auto out = std::vector<C>(batch);
+
+			Run(type, "CalculateIntegralRange", degree, batch, [&]() {
+				p.CalculateIntegralRange(a.data(), a.data() + batch, b.data() + 1, out.data());
+				sink = out[batch / 2];
+			});
+		}
+	}
+
+	//Chebyshev series are only defined for floating point coefficients
+	template <typename C> void RunChebyshev(const char*, const Polynomial<C>&, const std::size_t, const std::vector<std::size_t>&, std::true_type) {}
+
+	//Clenshaw against the Horner rows above, with the coefficients of p taken as Chebyshev coefficients
+	template <typename C> void RunChebyshev(const char* type, const Polynomial<C>& p, const std::size_t degree,
+		const std::vector<std::size_t>& batches, std::false_type)
+	{
+		const ChebyshevPolynomial<C> c(std::vector<C>(p.Data(), p.Data() + p.Size()));
+
+		for (auto batch : batches)
+		{
+			auto points = MakePoints<C>(batch);
+			auto out = std::vector<C>(batch);
+
+			Run(type, "ChebyshevPolynomial::ValueAtRange", degree, batch, [&]() {
+				c.ValueAtRange(points.data(), points.data() + batch, out.data());
+				sink = out[batch / 2];
+			});
+		}
+	}
+
+	template <typename C> void RunType()
+	{
+		const auto type = TypeName<C>();
+
+		const auto degrees = options.quick ? std::vector<std::size_t>{ 4, 64, 512 }
+			: std::vector<std::size_t>{ 4, 8, 16, 64, 256, 1024, 4096 };
+
+		const auto batches = options.quick ? std::vector<std::size_t>{ 16, 1024 }
+			: std::vector<std::size_t>{ 1, 16, 256, 4096, 65536 };
+
+		for (auto degree : degrees)
+		{
+			const auto p = MakePolynomial<C>(degree);
+			const auto q = MakePolynomial<C>(degree);
+			const auto x = Value<C>(7);
+
+			Run(type, "Copy", degree, 1, [&]() {
+				Polynomial<C> c(p);
+				sink = c.GetCoefficient(0);
+			});
+
+			//Moves back and forth between two polynomials, so no copy is timed
+			Polynomial<C> slots[2] = { p, Polynomial<C>(std::initializer_list<C>{}) };
+			std::size_t from = 0;
+			Run(type, "Move", degree, 1, [&]() {
+				slots[1 - from] = std::move(slots[from]);
+				from = 1 - from;
+				sink = slots[from].GetCoefficient(0);
+			});
+
+			Run(type, "ValueAt", degree, 1, [&]() { sink = p.ValueAt(x); });
+
+			for (auto batch : batches)
+			{
+				auto points = MakePoints<C>(batch);
+				auto out = std::vector<C>(batch);
+
+				Run(type, "ValueAtRange", degree, batch, [&]() {
+					p.ValueAtRange(points.data(), points.data() + batch, out.data());
+					sink = out[batch / 2];
+				});
+			}
+
+			Run(type, "operator+", degree, 1, [&]() { sink = (p + q).GetCoefficient(0); });
+
+			Run(type, "operator*=", degree, 1, [&]() {
+				Polynomial<C> c(p);
+				c *= q;
+				sink = c.GetCoefficient(0);
+			});
+
+			Run(type, "CalculateDerivative", degree, 1, [&]() { sink = p.CalculateDerivative().GetCoefficient(0); });
+
+			auto roots = MakePoints<C>(degree);
+			Run(type, "AddRootRange", degree, 1, [&]() {
+				Polynomial<C> c(C(1), 0);
+				c.template AddRootRange<std::vector<C>>(roots.begin(), roots.end());
+				sink = c.GetCoefficient(0);
+			});
+
+			typename std::is_integral<C>::type isIntegral;
+			RunIntegrals(type, p, degree, batches, isIntegral);
+			RunChebyshev(type, p, degree, batches, isIntegral);
+
+			//Many low degree polynomials, each at its own point, as separate objects and as a batch
+			if (degree <= 16)
+			{
+				for (auto batch : batches)
+				{
+					auto polynomials = std::vector<Polynomial<C>>(batch, p);
+					auto points = MakePoints<C>(batch);
+					auto out = std::vector<C>(batch);
+
+					Run(type, "ValueAt per polynomial", degree, batch, [&]() {
+						for (std::size_t j = 0; j < batch; j++)
+						{
+							out[j] = polynomials[j].ValueAt(points[j]);
+						}
+						sink = out[batch / 2];
+					});
+
+					PolynomialBatch<C> soa(polynomials.begin(), polynomials.end());
+					Run(type, "PolynomialBatch::ValueAt", degree, batch, [&]() {
+						soa.ValueAt(points.data(), out.data());
+						sink = out[batch / 2];
+					});
+				}
+			}
+		}
+	}
+}
+
+int main(int argc, char** argv)
+{
+	for (int i = 1; i < argc; i++)
+	{
+		const std::string arg = argv[i];
+
+		if (arg == "--json")
+		{
+			options.json = true;
+		}
+		else if (arg == "--quick")
+		{
+			options.quick = true;
+		}
+		else if (arg == "--inline")
+		{
+			options.inlineExecutor = true;
+		}
+		else if (arg.compare(0, 9, "--filter=") == 0)
+		{
+			options.filter = arg.substr(9);
+		}
+		else
+		{
+			std::fprintf(stderr, "Usage: %s [--json] [--quick] [--inline] [--filter=operation]\n", argv[0]);
+			return 1;
+		}
+	}
+
+	InlineExecutor inlineExecutor;
+	if (options.inlineExecutor)
+	{
+		SetDefaultExecutor(&inlineExecutor);
+	}
+
+	RunType<int>();
+	RunType<float>();
+	RunType<double>();
+	RunType<long double>();
+
+	if (options.json)
+	{
+		std::printf(firstRow ? "[]\n" : "\n]\n");
+	}
+
+	SetDefaultExecutor(nullptr);
+
+	return 0;
+}
@@ -0,0 +1,4 @@
+rm -f "benchmark.exe"
+D:/cygwin64/bin/g++ Polynomial.cpp Executor.cpp MemoryResource.cpp PolynomialStats.cpp PolynomialBank.cpp -std=c++14 -O2 benchmark.cpp -o benchmark
+echo "--------------------------------------------------------"
+benchmark.exe > benchmark.csv
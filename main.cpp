@@ -11,9 +11,55 @@
 #define BOOST_TEST_MODULE
 #include <boost/test/unit_test.hpp>
 #include "Polynomial.h"
+#include "PolynomialExpression.h"
+#include "StaticPolynomial.h"
+#include "MemoryResource.h"
+#include "PolynomialStats.h"
+#include "PolynomialBank.h"
+#include "PolynomialFormat.h"
+#include "PolynomialBatch.h"
+#include "ModInt.h"
+#include "ChebyshevPolynomial.h"
+#include <sstream>
+#include <fstream>
+#include <cstdio>
 #include <vector>
 #include <stdexcept>
 #include <limits>
+#include <array>
+#include <thread>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+//Counts heap allocations, for checking that small polynomials don't allocate
+std::atomic<std::size_t> allocationCount(0);
+
+/*
+	The replacements are not inlined, as GCC would otherwise see malloc and free paired with
+	operator delete and operator new where they meet, and warn of mismatched allocation functions.
+*/
+__attribute__((noinline)) void* operator new(std::size_t size)
+{
+	allocationCount++;
+
+	if (void* p = std::malloc(size > 0 ? size : 1))
+	{
+		return p;
+	}
+
+	throw std::bad_alloc();
+}
+
+__attribute__((noinline)) void operator delete(void* p) noexcept
+{
+	std::free(p);
+}
+
+__attribute__((noinline)) void operator delete(void* p, std::size_t) noexcept
+{
+	std::free(p);
+}
 
 /*
 	UNIT TESTS
@@ -612,4 +658,1477 @@ BOOST_AUTO_TEST_CASE(Star__Equal_Operator)
 	}
 
 	std::cout << res << std::endl;
-}
\ No newline at end of file
+}
+template <typename C> void ValuateRangeTest()
+{
+	//High enough degree to use Estrin for single points, and a point count that leaves a scalar tail
+	Polynomial<C> p;
+	for (unsigned int i = 0; i < 40; i++)
+	{
+		p.SetCoefficient(static_cast<C>(i % 7 + 1), i);
+	}
+
+	auto x = std::vector<C>(37);
+	for (unsigned int i = 0; i < x.size(); i++)
+	{
+		x[i] = static_cast<C>(0.1) + static_cast<C>(i) / 32;
+	}
+
+	auto res = std::vector<C>(x.size());
+	p.ValueAtRange(x.data(), x.data() + x.size(), res.data());
+
+	for (unsigned int i = 0; i < x.size(); i++)
+	{
+		//Naive reference
+		long double expected = 0;
+		for (unsigned int j = 0; j <= p.GetHighestCoefficient(); j++)
+		{
+			expected += p.GetCoefficient(j) * std::pow(static_cast<long double>(x[i]), j);
+		}
+
+		BOOST_CHECK_CLOSE_FRACTION(static_cast<long double>(res[i]), expected, 1e-3);
+		BOOST_CHECK_CLOSE_FRACTION(static_cast<long double>(p.ValueAt(x[i])), expected, 1e-3);
+	}
+}
+
+BOOST_AUTO_TEST_CASE(Valuate_Range)
+{
+	ValuateRangeTest<float>();
+	ValuateRangeTest<double>();
+	ValuateRangeTest<long double>();
+}
+
+BOOST_AUTO_TEST_CASE(Valuate_Range_int)
+{
+	Polynomial<int> p{5, -1, 4, 2};
+	auto x = std::vector<int>{-4, -3, -2, -1, 0, 1, 2, 3, 4, 5};
+	auto res = std::vector<int>(x.size());
+
+	p.ValueAtRange(x.data(), x.data() + x.size(), res.data());
+
+	for (std::size_t i = 0; i < x.size(); i++)
+	{
+		BOOST_CHECK_EQUAL(res[i], 5 - x[i] + 4 * x[i] * x[i] + 2 * x[i] * x[i] * x[i]);
+	}
+}
+
+template <typename C> void MultiplicationEngineTest(const unsigned int n, const unsigned int m)
+{
+	Polynomial<C> p;
+	Polynomial<C> p2;
+	for (unsigned int i = 0; i < n; i++)
+	{
+		p.SetCoefficient(static_cast<C>(static_cast<int>(i * 7 % 11) - 5), i);
+	}
+	for (unsigned int i = 0; i < m; i++)
+	{
+		p2.SetCoefficient(static_cast<C>(static_cast<int>(i * 5 % 13) - 6), i);
+	}
+
+	auto defaults = Polynomial<C>::GetMultiplicationThresholds();
+
+	//Schoolbook reference
+	Polynomial<C>::SetMultiplicationThresholds({ std::numeric_limits<std::size_t>::max(), std::numeric_limits<std::size_t>::max() });
+	auto expected = p * p2;
+
+	//Karatsuba
+	Polynomial<C>::SetMultiplicationThresholds({ 4, std::numeric_limits<std::size_t>::max() });
+	auto karatsuba = p * p2;
+
+	//FFT (NTT for integer types)
+	Polynomial<C>::SetMultiplicationThresholds({ 4, 8 });
+	auto fft = p * p2;
+
+	Polynomial<C>::SetMultiplicationThresholds(defaults);
+
+	BOOST_REQUIRE(expected.Size() == n + m - 1);
+	BOOST_REQUIRE(karatsuba.Size() == n + m - 1);
+	BOOST_REQUIRE(fft.Size() == n + m - 1);
+
+	for (unsigned int i = 0; i < expected.Size(); i++)
+	{
+		BOOST_CHECK_EQUAL(karatsuba.GetCoefficient(i), expected.GetCoefficient(i));
+		BOOST_CHECK(std::abs(fft.GetCoefficient(i) - expected.GetCoefficient(i)) < 1e-2);
+	}
+}
+
+BOOST_AUTO_TEST_CASE(Multiplication_Engine)
+{
+	MultiplicationEngineTest<int>(100, 37);
+	MultiplicationEngineTest<float>(64, 64);
+	MultiplicationEngineTest<double>(33, 200);
+	MultiplicationEngineTest<long double>(129, 17);
+}
+
+BOOST_AUTO_TEST_CASE(Sparse_Constructor)
+{
+	Polynomial<double> p(3, 1000000);
+
+	BOOST_REQUIRE(p.GetHighestCoefficient() == 1000000);
+	BOOST_CHECK_EQUAL(p.GetCoefficient(1000000), 3);
+	BOOST_CHECK_EQUAL(p.GetCoefficient(500000), 0);
+	BOOST_CHECK_THROW(p.GetCoefficient(1000001), std::out_of_range);
+
+	BOOST_CHECK_EQUAL(p.ValueAt(1), 3);
+	BOOST_CHECK_EQUAL(p.ValueAt(-1), 3);
+	BOOST_CHECK_CLOSE(Polynomial<double>(1, 100).ValueAt(1.01), std::pow(1.01, 100), 1e-9);
+}
+
+BOOST_AUTO_TEST_CASE(Sparse_Arithmetic)
+{
+	//(x^100000 + 2) * (2x^50000 - 1)
+	Polynomial<double> p(1, 100000);
+	p.SetCoefficient(2, 0);
+
+	Polynomial<double> p2(2, 50000);
+	p2.SetCoefficient(-1, 0);
+
+	auto product = p * p2;
+	BOOST_REQUIRE(product.GetHighestCoefficient() == 150000);
+	BOOST_CHECK_EQUAL(product.GetCoefficient(150000), 2);
+	BOOST_CHECK_EQUAL(product.GetCoefficient(100000), -1);
+	BOOST_CHECK_EQUAL(product.GetCoefficient(50000), 4);
+	BOOST_CHECK_EQUAL(product.GetCoefficient(0), -2);
+	BOOST_CHECK_EQUAL(product.GetCoefficient(1), 0);
+
+	//Sparse plus dense
+	auto sum = p + Polynomial<double>{1, 1, 1};
+	BOOST_REQUIRE(sum.GetHighestCoefficient() == 100000);
+	BOOST_CHECK_EQUAL(sum.GetCoefficient(0), 3);
+	BOOST_CHECK_EQUAL(sum.GetCoefficient(2), 1);
+	BOOST_CHECK_EQUAL(sum.GetCoefficient(100000), 1);
+
+	//Terms cancelling out
+	p2.Scale(-1);
+	auto cancelled = Polynomial<double>(2, 50000) + p2;
+	BOOST_CHECK_EQUAL(cancelled.GetCoefficient(50000), 0);
+	BOOST_CHECK_EQUAL(cancelled.GetCoefficient(0), 1);
+
+	//Adding a root to a sparse polynomial
+	p.AddRoot(2);
+	BOOST_REQUIRE(p.GetHighestCoefficient() == 100001);
+	BOOST_CHECK_EQUAL(p.GetCoefficient(100001), 1);
+	BOOST_CHECK_EQUAL(p.GetCoefficient(100000), -2);
+	BOOST_CHECK_EQUAL(p.GetCoefficient(1), 2);
+	BOOST_CHECK_EQUAL(p.GetCoefficient(0), -4);
+}
+
+BOOST_AUTO_TEST_CASE(Sparse_Derivative_Integral)
+{
+	Polynomial<double> p(3, 1000);
+	p.SetCoefficient(1, 0);
+
+	auto pMark = p.CalculateDerivative();
+	BOOST_REQUIRE(pMark.GetHighestCoefficient() == 999);
+	BOOST_CHECK_EQUAL(pMark.GetCoefficient(999), 3000);
+	BOOST_CHECK_EQUAL(pMark.GetCoefficient(0), 0);
+
+	//Integral of 3x^1000 + 1 from 0 to 1
+	BOOST_CHECK_CLOSE(p.CalculateIntegral(0, 1), 3. / 1001. + 1., 1e-9);
+}
+
+BOOST_AUTO_TEST_CASE(Sparse_To_Dense)
+{
+	Polynomial<int> p(1, 200);
+
+	//Filling in the coefficients switches back to dense storage, keeping the values
+	for (unsigned int i = 0; i < 200; i++)
+	{
+		p.SetCoefficient(i, i);
+	}
+
+	BOOST_REQUIRE(p.GetHighestCoefficient() == 200);
+	for (unsigned int i = 0; i < 200; i++)
+	{
+		BOOST_CHECK_EQUAL(p.GetCoefficient(i), i);
+	}
+	BOOST_CHECK_EQUAL(p.GetCoefficient(200), 1);
+	BOOST_CHECK_EQUAL(p.ValueAt(1), 199 * 200 / 2 + 1);
+}
+
+BOOST_AUTO_TEST_CASE(Integral_Cache)
+{
+	Polynomial<double> p{5, -1, 4, 2};
+
+	//Fractional bounds, which an integer keyed cache would truncate
+	BOOST_CHECK_CLOSE(p.CalculateIntegral(0.5, 1.5), 5. - 1. + 4. * 13. / 12. + 2. * 5. / 4., 1e-9);
+
+	//Concurrent readers share the cached antiderivative
+	auto areas = std::vector<double>(4);
+	auto threads = std::vector<std::thread>();
+	for (unsigned int i = 0; i < areas.size(); i++)
+	{
+		threads.emplace_back([&p, &areas, i]() { areas[i] = p.CalculateIntegral(3, 5); });
+	}
+	for (auto& t : threads)
+	{
+		t.join();
+	}
+	for (auto area : areas)
+	{
+		BOOST_CHECK_CLOSE(area, 1214. / 3., 1e-9);
+	}
+
+	//Altering the polynomial invalidates the cache
+	p.SetCoefficient(0, 3);
+	BOOST_CHECK_CLOSE(p.CalculateIntegral(3, 5), 1214. / 3. - (625. - 81.) / 2., 1e-9);
+}
+
+BOOST_AUTO_TEST_CASE(Executor_Thread_Pool)
+{
+	ThreadPool pool(4);
+
+	//Nested parallel loops, waiting inside tasks
+	auto sums = std::vector<std::size_t>(64);
+	ParallelFor(pool, sums.size(), 1, [&](const std::size_t begin, const std::size_t end) {
+		for (auto i = begin; i < end; i++)
+		{
+			std::atomic<std::size_t> sum(0);
+			ParallelFor(pool, 1000, 10, [&](const std::size_t b, const std::size_t e) {
+				for (auto j = b; j < e; j++)
+				{
+					sum += j;
+				}
+			});
+			sums[i] = sum;
+		}
+	});
+
+	for (auto sum : sums)
+	{
+		BOOST_CHECK_EQUAL(sum, 999 * 1000 / 2);
+	}
+
+	//Exceptions are passed on to the waiting thread
+	TaskGroup group(pool);
+	group.Run([]() { throw std::runtime_error("Task failed"); });
+	BOOST_CHECK_THROW(group.Wait(), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(Executor_Polynomial)
+{
+	Polynomial<int> p;
+	Polynomial<double> q;
+	for (unsigned int i = 0; i < 70000; i++)
+	{
+		if (i < 1500)
+		{
+			p.SetCoefficient(static_cast<int>(i % 5) - 2, i);
+		}
+		q.SetCoefficient(1. / (i + 1), i);
+	}
+
+	auto x = std::vector<double>(5000);
+	for (unsigned int i = 0; i < x.size(); i++)
+	{
+		x[i] = static_cast<double>(i) / x.size();
+	}
+
+	//Reference results, computed synchronously
+	InlineExecutor inlineExecutor;
+	SetDefaultExecutor(&inlineExecutor);
+
+	auto expectedProduct = p * p;
+	auto expectedArea = q.CalculateIntegral(0, 0.5);
+	auto expectedValues = std::vector<double>(x.size());
+	q.ValueAtRange(x.data(), x.data() + x.size(), expectedValues.data());
+
+	//Same operations on a thread pool
+	ThreadPool pool(4);
+	SetDefaultExecutor(&pool);
+
+	auto product = p * p;
+	auto area = q.CalculateIntegral(0, 0.5);
+	auto values = std::vector<double>(x.size());
+	q.ValueAtRange(x.data(), x.data() + x.size(), values.data());
+
+	SetDefaultExecutor(nullptr);
+
+	BOOST_REQUIRE(product.GetHighestCoefficient() == expectedProduct.GetHighestCoefficient());
+	for (unsigned int i = 0; i < product.Size(); i++)
+	{
+		BOOST_CHECK_EQUAL(product.GetCoefficient(i), expectedProduct.GetCoefficient(i));
+	}
+
+	BOOST_CHECK_EQUAL(area, expectedArea);
+	BOOST_CHECK(values == expectedValues);
+}
+
+BOOST_AUTO_TEST_CASE(Integral_Range)
+{
+	Polynomial<double> p{5, -1, 4, 2};
+
+	//Adjacent and overlapping intervals, sharing bounds
+	auto a = std::vector<double>{3, 5, -1, 0.25, 3};
+	auto b = std::vector<double>{5, 7, 1, 0.75, 7};
+	auto areas = std::vector<double>(a.size());
+
+	p.CalculateIntegralRange(a.data(), a.data() + a.size(), b.data(), areas.data());
+
+	for (unsigned int i = 0; i < a.size(); i++)
+	{
+		BOOST_CHECK_CLOSE(areas[i], p.CalculateIntegral(a[i], b[i]), 1e-9);
+	}
+
+	BOOST_CHECK_CLOSE(areas[0], 1214. / 3., 1e-9);
+
+	//Integer types are rejected, without writing out
+	Polynomial<int> q{ 5, -1, 4, 2 };
+	auto ia = std::vector<int>{ 0, 1 };
+	auto ib = std::vector<int>{ 2, 3 };
+	auto iareas = std::vector<int>{ 7, 7 };
+	BOOST_CHECK_THROW(q.CalculateIntegralRange(ia.data(), ia.data() + ia.size(), ib.data(), iareas.data()), std::domain_error);
+	BOOST_CHECK_THROW(q.CalculateIntegralBins(ia.data(), ia.data() + ia.size(), iareas.data()), std::domain_error);
+	BOOST_CHECK_THROW(q.CalculateIntegral(0, 1), std::domain_error);
+	BOOST_CHECK_EQUAL(iareas[0], 7);
+}
+
+BOOST_AUTO_TEST_CASE(Integral_Bins)
+{
+	Polynomial<float> p{5, -1, 4, 2};
+
+	auto breakpoints = std::vector<float>(101);
+	for (unsigned int i = 0; i < breakpoints.size(); i++)
+	{
+		breakpoints[i] = -1 + i * 0.02f;
+	}
+
+	auto areas = std::vector<float>(breakpoints.size() - 1);
+	p.CalculateIntegralBins(breakpoints.data(), breakpoints.data() + breakpoints.size(), areas.data());
+
+	float total = 0;
+	for (unsigned int i = 0; i < areas.size(); i++)
+	{
+		BOOST_CHECK_CLOSE(areas[i], p.CalculateIntegral(breakpoints[i], breakpoints[i + 1]), 1e-2);
+		total += areas[i];
+	}
+
+	BOOST_CHECK_CLOSE(total, p.CalculateIntegral(-1, 1), 1e-3);
+}
+
+BOOST_AUTO_TEST_CASE(Mutation)
+{
+	Polynomial<double> p{5, -1, 4, 2};
+	BOOST_CHECK_CLOSE(p.CalculateIntegral(3, 5), 1214. / 3., 1e-9);
+
+	{
+		auto m = p.Mutate();
+		BOOST_REQUIRE_EQUAL(m.Size(), 4);
+
+		m.Resize(6);
+		m[5] = 1;
+		for (std::size_t i = 0; i < m.Size(); i++)
+		{
+			m.Data()[i] *= 2;
+		}
+	}
+
+	auto expectedResult = std::vector<double>{10, -2, 8, 4, 0, 2};
+	BOOST_REQUIRE(p.GetHighestCoefficient() == expectedResult.size() - 1);
+	for (unsigned int i = 0; i <= p.GetHighestCoefficient(); i++)
+	{
+		BOOST_CHECK_EQUAL(p.GetCoefficient(i), expectedResult[i]);
+	}
+
+	//The integral cache has been invalidated by the mutation
+	BOOST_CHECK_CLOSE(p.CalculateIntegral(0, 1), 10. - 1. + 8. / 3. + 1. + 2. / 6., 1e-9);
+
+	//Mutating a sparse polynomial keeps its values
+	Polynomial<double> sparse(1, 10000);
+	{
+		auto m = sparse.Mutate();
+		m[0] = 3;
+	}
+	BOOST_CHECK_EQUAL(sparse.GetCoefficient(0), 3);
+	BOOST_CHECK_EQUAL(sparse.GetCoefficient(10000), 1);
+	BOOST_CHECK_EQUAL(sparse.ValueAt(1), 4);
+}
+
+BOOST_AUTO_TEST_CASE(Add_Root_Range_Product_Tree)
+{
+	//Exact for integers
+	auto roots = std::vector<int>();
+	for (auto i = 0; i < 40; i++)
+	{
+		roots.push_back(i % 3 - 1);
+	}
+
+	Polynomial<int> p{3, 1};
+	Polynomial<int> expected{3, 1};
+	p.AddRootRange<std::vector<int>>(roots.cbegin(), roots.cend());
+	for (auto root : roots)
+	{
+		expected.AddRoot(root);
+	}
+
+	BOOST_REQUIRE(p.GetHighestCoefficient() == expected.GetHighestCoefficient());
+	for (unsigned int i = 0; i < p.Size(); i++)
+	{
+		BOOST_CHECK_EQUAL(p.GetCoefficient(i), expected.GetCoefficient(i));
+	}
+
+	//Large enough for fast multiplication in the upper levels
+	auto realRoots = std::vector<double>();
+	for (auto i = 0; i < 600; i++)
+	{
+		realRoots.push_back((i % 5 - 2) * 0.5);
+	}
+
+	Polynomial<double> q;
+	q.SetCoefficient(1, 0);
+	Polynomial<double> expectedQ(q);
+	q.AddRootRange<std::vector<double>>(realRoots.cbegin(), realRoots.cend());
+	for (auto root : realRoots)
+	{
+		expectedQ.AddRoot(root);
+	}
+
+	double largest = 0;
+	for (unsigned int i = 0; i <= expectedQ.GetHighestCoefficient(); i++)
+	{
+		largest = std::max(largest, std::abs(expectedQ.GetCoefficient(i)));
+	}
+
+	BOOST_REQUIRE(q.GetHighestCoefficient() == expectedQ.GetHighestCoefficient());
+	for (unsigned int i = 0; i <= q.GetHighestCoefficient(); i++)
+	{
+		BOOST_CHECK(std::abs(q.GetCoefficient(i) - expectedQ.GetCoefficient(i)) <= 1e-9 * largest);
+	}
+}
+
+BOOST_AUTO_TEST_CASE(Valuate_Multipoint)
+{
+	Polynomial<int> p;
+	for (unsigned int i = 0; i < 100; i++)
+	{
+		p.SetCoefficient(static_cast<int>(i % 5) - 2, i);
+	}
+
+	auto x = std::vector<int>();
+	for (auto i = 0; i < 90; i++)
+	{
+		x.push_back(i % 3 - 1);
+	}
+
+	auto expected = std::vector<int>(x.size());
+	p.ValueAtRange(x.data(), x.data() + x.size(), expected.data());
+
+	//Force the remainder tree, with Newton division in the upper levels
+	auto defaultThreshold = Polynomial<int>::GetMultipointThreshold();
+	auto defaults = Polynomial<int>::GetMultiplicationThresholds();
+	Polynomial<int>::SetMultipointThreshold(1);
+	Polynomial<int>::SetMultiplicationThresholds({ 4, defaults.fft });
+
+	auto res = std::vector<int>(x.size());
+	p.ValueAtRange(x.data(), x.data() + x.size(), res.data());
+
+	Polynomial<int>::SetMultipointThreshold(defaultThreshold);
+	Polynomial<int>::SetMultiplicationThresholds(defaults);
+
+	BOOST_CHECK(res == expected);
+
+	//Floating point, on a point count where the subproduct tree stays well conditioned
+	Polynomial<double> q;
+	for (unsigned int i = 0; i < 40; i++)
+	{
+		q.SetCoefficient(1. / (i + 1), i);
+	}
+
+	auto y = std::vector<double>();
+	for (auto i = 0; i < 24; i++)
+	{
+		y.push_back(-1 + i / 12.);
+	}
+
+	auto expectedQ = std::vector<double>(y.size());
+	q.ValueAtRange(y.data(), y.data() + y.size(), expectedQ.data());
+
+	Polynomial<double>::SetMultipointThreshold(1);
+	auto resQ = std::vector<double>(y.size());
+	q.ValueAtRange(y.data(), y.data() + y.size(), resQ.data());
+	Polynomial<double>::SetMultipointThreshold(std::numeric_limits<std::size_t>::max());
+
+	for (unsigned int i = 0; i < y.size(); i++)
+	{
+		BOOST_CHECK(std::abs(resQ[i] - expectedQ[i]) < 1e-6);
+	}
+}
+
+BOOST_AUTO_TEST_CASE(Rvalue_Operators)
+{
+	Polynomial<int> a{ 1, 2 };
+	Polynomial<int> b{ 0, 1, 3 };
+	Polynomial<int> c{ 2, 0, 0, 1 };
+
+	//(1 + 2x) + (x + 3x^2) + (1 + 2x)(2 + x^3) = 3 + 7x + 3x^2 + x^3 + 2x^4
+	auto p = a + b + a * c;
+	auto q = a + (b + a * c);
+
+	for (auto r : { p, q })
+	{
+		BOOST_CHECK_EQUAL(r.GetHighestCoefficient(), 4);
+		BOOST_CHECK_EQUAL(r.GetCoefficient(0), 3);
+		BOOST_CHECK_EQUAL(r.GetCoefficient(1), 7);
+		BOOST_CHECK_EQUAL(r.GetCoefficient(2), 3);
+		BOOST_CHECK_EQUAL(r.GetCoefficient(3), 1);
+		BOOST_CHECK_EQUAL(r.GetCoefficient(4), 2);
+	}
+
+	//Operands are left untouched
+	BOOST_CHECK_EQUAL(a.GetHighestCoefficient(), 1);
+	BOOST_CHECK_EQUAL(b.GetCoefficient(2), 3);
+
+	auto s = (a + b) * (a * c);
+	BOOST_CHECK_EQUAL(s.GetHighestCoefficient(), 6);
+	BOOST_CHECK_EQUAL(s.GetCoefficient(0), 2);
+	BOOST_CHECK_EQUAL(s.GetCoefficient(6), 6);
+}
+
+BOOST_AUTO_TEST_CASE(Expression_Templates)
+{
+	using namespace PolynomialExpression;
+
+	Polynomial<double> a{ 1, 2, 3 };
+	Polynomial<double> b{ 4, 5 };
+	Polynomial<double> c(1, 100);
+
+	auto p = Evaluate(Lazy(a) + 2. * Lazy(b) - Lazy(c) * 0.5 + a);
+
+	BOOST_CHECK_EQUAL(p.GetHighestCoefficient(), 100);
+	BOOST_CHECK_EQUAL(p.GetCoefficient(0), 10);
+	BOOST_CHECK_EQUAL(p.GetCoefficient(1), 14);
+	BOOST_CHECK_EQUAL(p.GetCoefficient(2), 6);
+	BOOST_CHECK_EQUAL(p.GetCoefficient(50), 0);
+	BOOST_CHECK_EQUAL(p.GetCoefficient(100), -0.5);
+}
+
+BOOST_AUTO_TEST_CASE(Inline_Storage)
+{
+	auto before = allocationCount.load();
+
+	Polynomial<double> p;
+	Polynomial<double> q{ 1, 2, 3, 4, 5, 6, 7, 8, 9 };
+	Polynomial<double> r(q);
+	Polynomial<double> s(std::move(r));
+	p = s;
+	p.SetCoefficient(2, 4);
+	p.Scale(3);
+	q = std::move(p);
+
+	BOOST_CHECK_EQUAL(allocationCount.load(), before);
+
+	BOOST_CHECK_EQUAL(q.GetHighestCoefficient(), 8);
+	BOOST_CHECK_EQUAL(q.GetCoefficient(4), 6);
+	BOOST_CHECK_EQUAL(q.GetCoefficient(8), 27);
+	BOOST_CHECK_EQUAL(s.GetCoefficient(8), 9);
+	BOOST_REQUIRE_THROW(r.GetCoefficient(0), std::out_of_range);
+
+	//Growing past the inline capacity moves the coefficients to the heap
+	q.SetCoefficient(10, 9);
+	BOOST_CHECK(allocationCount.load() > before);
+	BOOST_CHECK_EQUAL(q.GetCoefficient(9), 10);
+	BOOST_CHECK_EQUAL(q.GetCoefficient(4), 6);
+
+	//Moving a large polynomial hands over its buffer
+	before = allocationCount.load();
+	Polynomial<double> t(std::move(q));
+	BOOST_CHECK_EQUAL(allocationCount.load(), before);
+	BOOST_CHECK_EQUAL(t.GetCoefficient(9), 10);
+}
+
+BOOST_AUTO_TEST_CASE(Static_Polynomial)
+{
+	//3 + 2x + x^2, evaluated at compile time
+	constexpr StaticPolynomial<int, 3> p(3, 2, 1);
+	constexpr StaticPolynomial<int, 2> q(-1, 1);
+
+	static_assert(p.ValueAt(2) == 11, "Compile time evaluation");
+	static_assert(p.CalculateDerivative().ValueAt(5) == 12, "Compile time derivative");
+
+	//(3 + 2x + x^2)(x - 1) = -3 + x + x^2 + x^3
+	constexpr auto r = p * q;
+	static_assert(r.GetHighestCoefficient() == 3, "Product degree");
+	BOOST_CHECK_EQUAL(r.GetCoefficient(0), -3);
+	BOOST_CHECK_EQUAL(r.GetCoefficient(1), 1);
+	BOOST_CHECK_EQUAL(r.GetCoefficient(2), 1);
+	BOOST_CHECK_EQUAL(r.GetCoefficient(3), 1);
+
+	constexpr auto s = p + q;
+	BOOST_CHECK_EQUAL(s.GetCoefficient(0), 2);
+	BOOST_CHECK_EQUAL(s.GetCoefficient(2), 1);
+
+	//Antiderivative and integral match Polynomial
+	constexpr StaticPolynomial<double, 4> d(6, -20, 0, 40);
+	Polynomial<double> dynamic(static_cast<Polynomial<double>>(d));
+
+	BOOST_CHECK_EQUAL(d.CalculateAntiderivative().GetHighestCoefficient(), 4);
+	BOOST_CHECK_CLOSE(d.CalculateIntegral(-1, 2.5), dynamic.CalculateIntegral(-1, 2.5), 1e-9);
+	BOOST_CHECK_EQUAL(d.ValueAt(1.5), dynamic.ValueAt(1.5));
+
+	StaticPolynomial<double, 4> back(dynamic);
+	BOOST_CHECK_EQUAL(back.GetCoefficient(3), 40);
+
+	typedef StaticPolynomial<double, 4> Cubic;
+	dynamic.SetCoefficient(1, 4);
+	BOOST_REQUIRE_THROW(Cubic tooLong(dynamic), std::out_of_range);
+}
+
+BOOST_AUTO_TEST_CASE(Arena_Resource)
+{
+	Polynomial<double> p;
+	Polynomial<double> q;
+	for (unsigned int i = 0; i < 40; i++)
+	{
+		p.SetCoefficient(i + 1, i);
+		q.SetCoefficient(1, i);
+	}
+
+	auto expected = p * q + p;
+	Polynomial<double> kept;
+
+	MonotonicArena arena(1 << 16);
+	{
+		ResourceScope scope(&arena);
+
+		//Temporaries of the batch take their coefficients from the arena, once it has its first chunk
+		auto warmUp = p * q;
+		auto before = allocationCount.load();
+		auto r = p * q + p;
+		auto d = r.CalculateDerivative();
+		BOOST_CHECK_EQUAL(allocationCount.load(), before);
+
+		BOOST_CHECK(r.GetResource() == &arena);
+		BOOST_CHECK(arena.BytesUsed() > 0);
+
+		//Assigning to a polynomial from outside the scope copies into its own resource
+		kept = std::move(r);
+		BOOST_CHECK_EQUAL(d.GetCoefficient(0), expected.GetCoefficient(1));
+	}
+
+	arena.Release();
+	BOOST_CHECK_EQUAL(arena.BytesUsed(), 0);
+
+	BOOST_CHECK(kept.GetResource() == GetNewDeleteResource());
+	BOOST_REQUIRE_EQUAL(kept.Size(), expected.Size());
+	for (unsigned int i = 0; i < expected.Size(); i++)
+	{
+		BOOST_CHECK_EQUAL(kept.GetCoefficient(i), expected.GetCoefficient(i));
+	}
+
+	//Explicit resource
+	Polynomial<double> explicitResource(&arena);
+	explicitResource.SetCoefficient(1, 20);
+	BOOST_CHECK(explicitResource.GetResource() == &arena);
+	BOOST_CHECK(arena.BytesUsed() > 0);
+}
+
+BOOST_AUTO_TEST_CASE(Instrumentation)
+{
+	ResetPolynomialStats();
+
+	Polynomial<double> p{ 1, 2, 3 };
+	p.CalculateIntegral(0, 1);
+	p.CalculateIntegral(1, 2);
+
+	auto x = std::vector<double>{ 1, 2, 3, 4 };
+	auto y = std::vector<double>(x.size());
+	p.ValueAtRange(x.data(), x.data() + x.size(), y.data());
+	p.ValueAt(2);
+
+	Polynomial<double> q;
+	for (unsigned int i = 0; i < 100; i++)
+	{
+		q.SetCoefficient(1, i);
+	}
+	auto r = p * q;
+	auto s = q * q;
+
+	auto stats = GetPolynomialStats();
+
+	if (polynomialStatsEnabled)
+	{
+		BOOST_CHECK_EQUAL(stats.integralCacheMisses, 1);
+		BOOST_CHECK_EQUAL(stats.integralCacheHits, 1);
+		BOOST_CHECK_EQUAL(stats.batchEvaluations, 1);
+		BOOST_CHECK_EQUAL(stats.evaluatedPoints, 4);
+		BOOST_CHECK_EQUAL(stats.schoolbookMultiplications, 1);
+		BOOST_CHECK_EQUAL(stats.karatsubaMultiplications, 1);
+		BOOST_CHECK(stats.evaluations >= 1);
+		BOOST_CHECK(stats.allocations >= 2);
+	}
+	else
+	{
+		BOOST_CHECK_EQUAL(stats.integralCacheMisses, 0);
+		BOOST_CHECK_EQUAL(stats.allocations, 0);
+	}
+
+	ResetPolynomialStats();
+	BOOST_CHECK_EQUAL(GetPolynomialStats().evaluations, 0);
+
+	//Counts of other threads, including threads that have exited
+	auto threads = std::vector<std::thread>();
+	for (int t = 0; t < 4; t++)
+	{
+		threads.emplace_back([&]() {
+			for (int i = 0; i < 1000; i++)
+			{
+				p.ValueAt(i);
+			}
+		});
+	}
+
+	for (auto& t : threads)
+	{
+		t.join();
+	}
+
+	p.ValueAt(1);
+	BOOST_CHECK_EQUAL(GetPolynomialStats().evaluations, polynomialStatsEnabled ? 4001 : 0);
+}
+
+BOOST_AUTO_TEST_CASE(Binary_Bank)
+{
+	auto polynomials = std::vector<Polynomial<double>>{ { 1, 2, 3 }, { -4.5 }, { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 7 } };
+	polynomials.push_back(Polynomial<double>(2, 200));
+
+	//Round trip through a stream
+	std::stringstream stream;
+	WritePolynomialBank(stream, polynomials.begin(), polynomials.end());
+	auto read = ReadPolynomialBank<double>(stream);
+
+	BOOST_REQUIRE_EQUAL(read.size(), polynomials.size());
+	for (unsigned int i = 0; i < read.size(); i++)
+	{
+		BOOST_CHECK_EQUAL(read[i].GetHighestCoefficient(), polynomials[i].GetHighestCoefficient());
+		BOOST_CHECK_EQUAL(read[i].ValueAt(0.5), polynomials[i].ValueAt(0.5));
+	}
+
+	//Other coefficient types are rejected
+	stream.clear();
+	stream.seekg(0);
+	BOOST_REQUIRE_THROW(ReadPolynomialBank<float>(stream), std::runtime_error);
+
+	//Memory mapped bank
+	const auto path = std::string("polynomial_bank_test.bin");
+	{
+		std::ofstream file(path, std::ios::binary);
+		WritePolynomialBank(file, polynomials.begin(), polynomials.end());
+	}
+
+	{
+		PolynomialBank<double> bank(path);
+
+		BOOST_REQUIRE_EQUAL(bank.Count(), polynomials.size());
+		BOOST_CHECK_EQUAL(bank[0].GetCoefficient(2), 3);
+		BOOST_CHECK_EQUAL(bank[1].ValueAt(10), -4.5);
+		BOOST_CHECK_EQUAL(bank[2].GetHighestCoefficient(), 10);
+		BOOST_CHECK_EQUAL(bank[3].GetCoefficient(200), 2);
+		BOOST_CHECK_EQUAL(bank[3].ValueAt(1), 2);
+		BOOST_CHECK_EQUAL(reinterpret_cast<std::uintptr_t>(bank[2].Data()) % 16, 0);
+		BOOST_REQUIRE_THROW(bank[4], std::out_of_range);
+
+		auto copy = bank[0].ToPolynomial();
+		BOOST_CHECK_EQUAL(copy.ValueAt(2), polynomials[0].ValueAt(2));
+	}
+
+	std::remove(path.c_str());
+
+	//Truncated banks are rejected
+	auto bytes = stream.str();
+	auto truncated = std::vector<long double>(bytes.size() / sizeof(long double));
+	std::memcpy(truncated.data(), bytes.data(), truncated.size() * sizeof(long double) - 64);
+	BOOST_REQUIRE_THROW(PolynomialBankView<double>(truncated.data(), truncated.size() * sizeof(long double) - 64), std::runtime_error);
+
+	//Empty, huge and overflowing sizes in the first table entry are rejected before allocating
+	const auto sizes = std::vector<std::uint64_t>{ 0, 1ull << 40, 1ull << 61, ~0ull };
+	for (auto size : sizes)
+	{
+		auto corrupt = bytes;
+		std::memcpy(&corrupt[sizeof(PolynomialBankFormat::BankHeader) + sizeof(std::uint64_t)], &size, sizeof(size));
+
+		std::stringstream corruptStream(corrupt);
+		BOOST_CHECK_THROW(ReadPolynomialBank<double>(corruptStream), std::runtime_error);
+
+		auto aligned = std::vector<long double>(corrupt.size() / sizeof(long double) + 1);
+		std::memcpy(aligned.data(), corrupt.data(), corrupt.size());
+		BOOST_CHECK_THROW(PolynomialBankView<double>(aligned.data(), corrupt.size()), std::runtime_error);
+	}
+}
+
+BOOST_AUTO_TEST_CASE(Text_Format_Parse)
+{
+	Polynomial<int> p{ 1, 0, -20, 0, 40 };
+
+	char buffer[128];
+	auto result = FormatPolynomial(buffer, buffer + sizeof(buffer), p);
+	BOOST_REQUIRE(result.ok);
+	BOOST_CHECK_EQUAL(std::string(buffer, result.ptr), "P(x) = 40x^4 + 0x^3 + -20x^2 + 0x + 1");
+
+	FormatOptions options;
+	options.skipZeros = true;
+	result = FormatPolynomial(buffer, buffer + sizeof(buffer), p, options);
+	BOOST_CHECK_EQUAL(std::string(buffer, result.ptr), "P(x) = 40x^4 + -20x^2 + 1");
+
+	//Too small buffers are reported
+	result = FormatPolynomial(buffer, buffer + 10, p);
+	BOOST_CHECK(!result.ok);
+	BOOST_CHECK(result.ptr == buffer + 10);
+
+	//operator<< keeps following the stream's own formatting
+	std::ostringstream stream;
+	stream << std::fixed << std::showpos;
+	stream.precision(2);
+	stream << Polynomial<double>{ 0.5, 1 };
+	BOOST_CHECK_EQUAL(stream.str(), "P(x) = +1.00x + +0.50");
+
+	//Parse the output back, and free form input
+	const std::string text = "P(x) = 40x^4 + -20x^2 + 1 and more";
+	Polynomial<int> q;
+	auto parsed = ParsePolynomial(text.data(), text.data() + text.size(), q);
+	BOOST_REQUIRE(parsed.ok);
+	BOOST_CHECK_EQUAL(std::string(parsed.ptr), " and more");
+	BOOST_CHECK_EQUAL(q.GetHighestCoefficient(), 4);
+	BOOST_CHECK_EQUAL(q.GetCoefficient(2), -20);
+	BOOST_CHECK_EQUAL(q.GetCoefficient(0), 1);
+
+	const std::string freeForm = "x^2 - 3x + 2 - x^2 + 5x^3";
+	parsed = ParsePolynomial(freeForm.data(), freeForm.data() + freeForm.size(), q);
+	BOOST_REQUIRE(parsed.ok);
+	BOOST_CHECK_EQUAL(q.GetHighestCoefficient(), 3);
+	BOOST_CHECK_EQUAL(q.GetCoefficient(3), 5);
+	BOOST_CHECK_EQUAL(q.GetCoefficient(2), 0);
+	BOOST_CHECK_EQUAL(q.GetCoefficient(1), -3);
+
+	const std::string garbage = "hello";
+	parsed = ParsePolynomial(garbage.data(), garbage.data() + garbage.size(), q);
+	BOOST_CHECK(!parsed.ok);
+	BOOST_CHECK(parsed.ptr == garbage.data());
+
+	//Out of range exponents and coefficients fail the parse and leave q alone
+	const std::string hugeExponent = "3x^4294967297 + 1";
+	parsed = ParsePolynomial(hugeExponent.data(), hugeExponent.data() + hugeExponent.size(), q);
+	BOOST_CHECK(!parsed.ok);
+	BOOST_CHECK(parsed.ptr == hugeExponent.data());
+
+	const std::string hugeCoefficient = "3x + 99999999999";
+	parsed = ParsePolynomial(hugeCoefficient.data(), hugeCoefficient.data() + hugeCoefficient.size(), q);
+	BOOST_CHECK(!parsed.ok);
+
+	const std::string wrapping = "x + 123456789012345678901234567890";
+	Polynomial<double> wide;
+	BOOST_CHECK(!ParsePolynomial(wrapping.data(), wrapping.data() + wrapping.size(), q).ok);
+	BOOST_CHECK(ParsePolynomial(wrapping.data(), wrapping.data() + wrapping.size(), wide).ok);
+	BOOST_CHECK_EQUAL(q.GetCoefficient(3), 5);
+
+	//The smallest int is in range, and round trips
+	Polynomial<int> extremes{ std::numeric_limits<int>::min(), std::numeric_limits<int>::max(), -1 };
+	result = FormatPolynomial(buffer, buffer + sizeof(buffer), extremes);
+	BOOST_REQUIRE(result.ok);
+	BOOST_REQUIRE(ParsePolynomial(buffer, result.ptr, q).ok);
+	BOOST_CHECK_EQUAL(q.GetCoefficient(0), std::numeric_limits<int>::min());
+	BOOST_CHECK_EQUAL(q.GetCoefficient(1), std::numeric_limits<int>::max());
+	BOOST_CHECK_EQUAL(q.GetCoefficient(2), -1);
+
+	const std::string separated = "3x - 2147483648";
+	BOOST_REQUIRE(ParsePolynomial(separated.data(), separated.data() + separated.size(), q).ok);
+	BOOST_CHECK_EQUAL(q.GetCoefficient(0), std::numeric_limits<int>::min());
+
+	const std::string beyond = "-2147483649";
+	BOOST_CHECK(!ParsePolynomial(beyond.data(), beyond.data() + beyond.size(), q).ok);
+	const std::string doubleNegative = "x - -2147483648";
+	BOOST_CHECK(!ParsePolynomial(doubleNegative.data(), doubleNegative.data() + doubleNegative.size(), q).ok);
+
+	const std::string hugeFloating = "1e999x";
+	BOOST_CHECK(!ParsePolynomial(hugeFloating.data(), hugeFloating.data() + hugeFloating.size(), wide).ok);
+
+	//Floating point round trip with full precision
+	Polynomial<double> d{ 0.1, -2.5e-300, 1. / 3 };
+	options.skipZeros = false;
+	options.precision = 0;
+	result = FormatPolynomial(buffer, buffer + sizeof(buffer), d, options);
+	BOOST_REQUIRE(result.ok);
+
+	Polynomial<double> e;
+	BOOST_REQUIRE(ParsePolynomial(buffer, result.ptr, e).ok);
+	for (unsigned int i = 0; i < 3; i++)
+	{
+		BOOST_CHECK_EQUAL(e.GetCoefficient(i), d.GetCoefficient(i));
+	}
+}
+
+BOOST_AUTO_TEST_CASE(Division)
+{
+	Polynomial<int> a{ 3, -1, 4, 1, -5, 9 };
+	Polynomial<int> b{ 2, 6, 1 };
+	Polynomial<int> r{ -7, 2 };
+	auto dividend = a * b + r;
+
+	auto q = dividend / b;
+	BOOST_REQUIRE_EQUAL(q.Size(), a.Size());
+	for (unsigned int i = 0; i < a.Size(); i++)
+	{
+		BOOST_CHECK_EQUAL(q.GetCoefficient(i), a.GetCoefficient(i));
+	}
+
+	auto rem = dividend % b;
+	BOOST_REQUIRE_EQUAL(rem.Size(), r.Size());
+	BOOST_CHECK_EQUAL(rem.GetCoefficient(0), -7);
+	BOOST_CHECK_EQUAL(rem.GetCoefficient(1), 2);
+
+	//Dividing by a higher degree gives 0 and leaves the dividend as remainder
+	Polynomial<int> quotient;
+	Polynomial<int> remainder;
+	r.DivMod(b, quotient, remainder);
+	BOOST_CHECK_EQUAL(quotient.Size(), 1);
+	BOOST_CHECK_EQUAL(quotient.GetCoefficient(0), 0);
+	BOOST_CHECK_EQUAL(remainder.GetCoefficient(1), 2);
+
+	//Leading zeros of the divisor are ignored, and zero divisors throw
+	Polynomial<double> x{ -1, 0, 0, 1 };
+	Polynomial<double> y{ -1, 1, 0, 0 };
+	x /= y;
+	BOOST_REQUIRE_EQUAL(x.Size(), 3);
+	BOOST_CHECK_CLOSE(x.GetCoefficient(0), 1., 1e-9);
+	BOOST_CHECK_CLOSE(x.GetCoefficient(2), 1., 1e-9);
+	Polynomial<double> zero{ 0, 0 };
+	BOOST_CHECK_THROW(x / zero, std::domain_error);
+
+	//The in-place variants reuse the buffers
+	x = Polynomial<double>{ 1, 2, 3, 4, 5, 6 };
+	Polynomial<double> d{ 0.5, 2 };
+	Polynomial<double> dq{ 0, 0, 0, 0, 0 };
+	Polynomial<double> dr{ 0 };
+	auto before = allocationCount.load();
+	x.DivMod(d, dq, dr);
+	x %= d;
+	BOOST_CHECK_EQUAL(allocationCount.load(), before);
+	BOOST_CHECK_CLOSE(x.GetCoefficient(0), dr.GetCoefficient(0), 1e-9);
+	Polynomial<double> original{ 1, 2, 3, 4, 5, 6 };
+	BOOST_CHECK_CLOSE(x.GetCoefficient(0), original.ValueAt(-0.25), 1e-9);
+
+	//Divisor as the remainder, and as the quotient
+	auto divisor = d;
+	original.DivMod(divisor, dq, divisor);
+	BOOST_REQUIRE_EQUAL(divisor.Size(), 1);
+	BOOST_CHECK_CLOSE(divisor.GetCoefficient(0), original.ValueAt(-0.25), 1e-9);
+	BOOST_CHECK_CLOSE(dq.GetCoefficient(4), 3, 1e-9);
+
+	divisor = d;
+	original.DivMod(divisor, divisor, dr);
+	BOOST_REQUIRE_EQUAL(divisor.Size(), 5);
+	BOOST_CHECK_CLOSE(divisor.GetCoefficient(4), 3, 1e-9);
+	BOOST_CHECK_CLOSE(dr.GetCoefficient(0), original.ValueAt(-0.25), 1e-9);
+}
+
+BOOST_AUTO_TEST_CASE(Division_Newton)
+{
+	//Monic divisor, so the Newton reciprocal is exact for integers
+	Polynomial<int> a;
+	Polynomial<int> b;
+	Polynomial<int> r;
+	for (unsigned int i = 0; i < 40; i++)
+	{
+		a.SetCoefficient(static_cast<int>(i % 7) - 3, i);
+	}
+	for (unsigned int i = 0; i < 24; i++)
+	{
+		b.SetCoefficient(i == 23 ? 1 : static_cast<int>(i % 5) - 2, i);
+	}
+	for (unsigned int i = 0; i < 23; i++)
+	{
+		r.SetCoefficient(static_cast<int>(i % 3) + 1, i);
+	}
+
+	auto dividend = a * b + r;
+
+	auto defaults = Polynomial<int>::GetMultiplicationThresholds();
+	Polynomial<int>::SetMultiplicationThresholds({ 4, defaults.fft });
+
+	Polynomial<int> quotient;
+	Polynomial<int> remainder;
+	dividend.DivMod(b, quotient, remainder);
+
+	Polynomial<int>::SetMultiplicationThresholds(defaults);
+
+	BOOST_REQUIRE_EQUAL(quotient.Size(), a.Size());
+	for (unsigned int i = 0; i < a.Size(); i++)
+	{
+		BOOST_CHECK_EQUAL(quotient.GetCoefficient(i), a.GetCoefficient(i));
+	}
+
+	BOOST_REQUIRE_EQUAL(remainder.Size(), 23);
+	for (unsigned int i = 0; i < 23; i++)
+	{
+		BOOST_CHECK_EQUAL(remainder.GetCoefficient(i), r.GetCoefficient(i));
+	}
+}
+
+BOOST_AUTO_TEST_CASE(Find_Roots)
+{
+	//(x - 1)(x - 2)(x + 3) x^2 (x^2 + 1)
+	Polynomial<int> p{ 1, 0, 1 };
+	auto roots = std::vector<int>{ 1, 2, -3, 0, 0 };
+	p.AddRootRange<std::vector<int>>(roots.begin(), roots.end());
+
+	auto result = p.FindRoots();
+	BOOST_CHECK(result.converged);
+	BOOST_REQUIRE_EQUAL(result.roots.size(), 7);
+
+	auto expected = std::vector<std::complex<double>>{ { -3, 0 }, { 0, -1 }, { 0, 0 }, { 0, 0 }, { 0, 1 }, { 1, 0 }, { 2, 0 } };
+	auto order = [](const std::complex<double>& a, const std::complex<double>& b) {
+		return std::round(a.real() * 1e6) != std::round(b.real() * 1e6) ? a.real() < b.real() : a.imag() < b.imag();
+	};
+	std::sort(result.roots.begin(), result.roots.end(), order);
+
+	for (std::size_t i = 0; i < expected.size(); i++)
+	{
+		BOOST_CHECK_SMALL(std::abs(result.roots[i] - expected[i]), 1e-9);
+	}
+
+	//x^500 - 1 has the roots of unity, and stresses the scaling for large |x|
+	Polynomial<double> q(1., 500);
+	q.SetCoefficient(-1, 0);
+	auto unity = q.FindRoots();
+	BOOST_CHECK(unity.converged);
+	BOOST_REQUIRE_EQUAL(unity.roots.size(), 500);
+
+	auto angles = std::vector<double>();
+	for (auto& r : unity.roots)
+	{
+		BOOST_CHECK_SMALL(std::abs(r) - 1, 1e-12);
+		angles.push_back(std::arg(r) < -1e-9 ? std::arg(r) + 2 * std::acos(-1.) : std::arg(r));
+	}
+
+	std::sort(angles.begin(), angles.end());
+	for (std::size_t i = 0; i < angles.size(); i++)
+	{
+		BOOST_CHECK_SMALL(angles[i] - 2 * std::acos(-1.) * i / 500, 1e-9);
+	}
+
+	//Constants have no roots
+	BOOST_CHECK(Polynomial<float>{ 3 }.FindRoots().roots.empty());
+}
+
+BOOST_AUTO_TEST_CASE(Interpolation)
+{
+	//Integer interpolation is exact for integer polynomials
+	Polynomial<int> p{ 7, -3, 0, 2, 1 };
+	auto x = std::vector<int>{ -2, 5, 0, 3, 1 };
+	auto y = std::vector<int>(x.size());
+	p.ValueAtRange(x.data(), x.data() + x.size(), y.data());
+
+	auto q = Polynomial<int>::Interpolate(x.data(), x.data() + x.size(), y.data());
+	BOOST_REQUIRE_EQUAL(q.Size(), p.Size());
+	for (unsigned int i = 0; i < p.Size(); i++)
+	{
+		BOOST_CHECK_EQUAL(q.GetCoefficient(i), p.GetCoefficient(i));
+	}
+
+	x[3] = 0;
+	BOOST_CHECK_THROW(Polynomial<int>::Interpolate(x.data(), x.data() + x.size(), y.data()), std::invalid_argument);
+
+	//Newton and the subproduct tree agree in floating point, on a point count where the tree stays well conditioned
+	Polynomial<double> d;
+	auto dx = std::vector<double>();
+	for (unsigned int i = 0; i < 12; i++)
+	{
+		d.SetCoefficient(1. / (i + 1), i);
+		dx.push_back(std::cos(std::acos(-1.) * (i + 0.5) / 12));
+	}
+
+	auto dy = std::vector<double>(dx.size());
+	d.ValueAtRange(dx.data(), dx.data() + dx.size(), dy.data());
+
+	auto newton = Polynomial<double>::Interpolate(dx.data(), dx.data() + dx.size(), dy.data());
+
+	auto defaultThreshold = Polynomial<double>::GetMultipointThreshold();
+	Polynomial<double>::SetMultipointThreshold(1);
+	auto fast = Polynomial<double>::Interpolate(dx.data(), dx.data() + dx.size(), dy.data());
+	Polynomial<double>::SetMultipointThreshold(defaultThreshold);
+
+	BOOST_REQUIRE_EQUAL(newton.Size(), 12);
+	BOOST_REQUIRE_EQUAL(fast.Size(), 12);
+	for (unsigned int i = 0; i < 12; i++)
+	{
+		BOOST_CHECK_SMALL(newton.ValueAt(dx[i]) - dy[i], 1e-9);
+		BOOST_CHECK_SMALL(fast.ValueAt(dx[i]) - dy[i], 1e-9);
+	}
+
+	for (unsigned int i = 0; i < 12; i++)
+	{
+		BOOST_CHECK_SMALL(newton.GetCoefficient(i) - d.GetCoefficient(i), 1e-6);
+		BOOST_CHECK_SMALL(fast.GetCoefficient(i) - d.GetCoefficient(i), 1e-6);
+	}
+}
+
+BOOST_AUTO_TEST_CASE(Compose_Shift)
+{
+	Polynomial<int> p;
+	for (unsigned int i = 0; i < 21; i++)
+	{
+		p.SetCoefficient(static_cast<int>(i % 3) - 1, i);
+	}
+
+	//Shift in place, and back again
+	auto shifted = p;
+	shifted.Shift(1);
+	for (int x = -2; x <= 1; x++)
+	{
+		BOOST_CHECK_EQUAL(shifted.ValueAt(x), p.ValueAt(x + 1));
+	}
+
+	auto back = shifted;
+	back.Shift(-1);
+	for (unsigned int i = 0; i < p.Size(); i++)
+	{
+		BOOST_CHECK_EQUAL(back.GetCoefficient(i), p.GetCoefficient(i));
+	}
+
+	//Divide and conquer shift and composition
+	auto defaults = Polynomial<int>::GetMultiplicationThresholds();
+	Polynomial<int>::SetMultiplicationThresholds({ 4, defaults.fft });
+
+	auto fast = p;
+	fast.Shift(1);
+
+	auto composed = p;
+	composed.Compose(Polynomial<int>{ 0, 1, 1 });
+
+	Polynomial<int>::SetMultiplicationThresholds(defaults);
+
+	BOOST_REQUIRE_EQUAL(fast.Size(), shifted.Size());
+	for (unsigned int i = 0; i < fast.Size(); i++)
+	{
+		BOOST_CHECK_EQUAL(fast.GetCoefficient(i), shifted.GetCoefficient(i));
+	}
+
+	BOOST_CHECK_EQUAL(composed.Size(), 41);
+	for (int x = -2; x <= 1; x++)
+	{
+		BOOST_CHECK_EQUAL(composed.ValueAt(x), p.ValueAt(x * x + x));
+	}
+
+	//p(2x + 1) for p = 1 + 2x + 3x^2
+	Polynomial<double> d{ 1, 2, 3 };
+	d.Affine(2, 1);
+	BOOST_CHECK_EQUAL(d.GetCoefficient(0), 6);
+	BOOST_CHECK_EQUAL(d.GetCoefficient(1), 16);
+	BOOST_CHECK_EQUAL(d.GetCoefficient(2), 12);
+}
+
+BOOST_AUTO_TEST_CASE(Batch)
+{
+	//More polynomials than a tile, of mixed degree
+	auto polynomials = std::vector<Polynomial<float>>();
+	auto x = std::vector<float>();
+	for (unsigned int j = 0; j < 1000; j++)
+	{
+		Polynomial<float> p;
+		for (unsigned int k = 0; k <= j % 5; k++)
+		{
+			p.SetCoefficient(static_cast<float>(j % 7) - k, k);
+		}
+
+		polynomials.push_back(p);
+		x.push_back(static_cast<float>(j % 11) / 4 - 1);
+	}
+
+	PolynomialBatch<float> batch(polynomials.begin(), polynomials.end());
+	BOOST_CHECK_EQUAL(batch.Count(), 1000);
+	BOOST_CHECK_EQUAL(batch.Size(), 5);
+
+	auto values = std::vector<float>(batch.Count());
+	batch.ValueAt(x.data(), values.data());
+
+	auto derivative = batch.CalculateDerivative();
+	auto slopes = std::vector<float>(batch.Count());
+	derivative.ValueAt(x.data(), slopes.data());
+
+	auto zeros = std::vector<float>(batch.Count());
+	auto areas = std::vector<float>(batch.Count());
+	batch.CalculateIntegral(zeros.data(), x.data(), areas.data());
+
+	for (unsigned int j = 0; j < 1000; j++)
+	{
+		auto& p = polynomials[j];
+		BOOST_CHECK_CLOSE(values[j] + 1, p.ValueAt(x[j]) + 1, 1e-3);
+		BOOST_CHECK_CLOSE(slopes[j] + 1, p.CalculateDerivative().ValueAt(x[j]) + 1, 1e-3);
+		BOOST_CHECK_CLOSE(areas[j] + 1, p.CalculateIntegral(0, x[j]) + 1, 1e-3);
+	}
+
+	//Round trip, with padding zeros
+	auto q = batch.Get(3);
+	BOOST_REQUIRE_EQUAL(q.Size(), 5);
+	BOOST_CHECK_EQUAL(q.GetCoefficient(3), 0);
+	BOOST_CHECK_EQUAL(q.GetCoefficient(2), 1);
+
+	batch.Set(3, Polynomial<float>{ 1, 2 });
+	BOOST_CHECK_EQUAL(batch.GetCoefficient(3, 1), 2);
+	BOOST_CHECK_EQUAL(batch.GetCoefficient(3, 2), 0);
+	BOOST_CHECK_THROW(batch.Set(3, Polynomial<float>(1, 7)), std::out_of_range);
+}
+
+BOOST_AUTO_TEST_CASE(Execution_Policies)
+{
+	//Long operand against a short one, in the tiled schoolbook region
+	Polynomial<int> a;
+	Polynomial<int> b{ 3, -1, 4, 1, -5, 9, 2, -6 };
+	for (unsigned int i = 0; i < 200000; i++)
+	{
+		a.SetCoefficient(static_cast<int>(i % 13) - 6, i);
+	}
+
+	auto sequential = a;
+	sequential.Multiply(Execution::seq, b);
+	auto parallel = a;
+	parallel.Multiply(Execution::par, b);
+
+	BOOST_REQUIRE_EQUAL(parallel.Size(), sequential.Size());
+	BOOST_CHECK(std::equal(sequential.Data(), sequential.Data() + sequential.Size(), parallel.Data()));
+
+	//FFT with its stages split
+	Polynomial<double> x;
+	Polynomial<double> y;
+	for (unsigned int i = 0; i < 70000; i++)
+	{
+		x.SetCoefficient(static_cast<double>(i % 7) - 3, i);
+		y.SetCoefficient(static_cast<double>(i % 5) - 2, i);
+	}
+
+	ThreadPool pool(4);
+	auto fftSequential = x;
+	fftSequential.Multiply(Execution::seq, y);
+	auto fftParallel = x;
+	fftParallel.Multiply(Execution::par.On(pool), y);
+
+	BOOST_REQUIRE_EQUAL(fftParallel.Size(), fftSequential.Size());
+	for (unsigned int i = 0; i < fftParallel.Size(); i += 997)
+	{
+		BOOST_CHECK_SMALL(fftParallel.GetCoefficient(i) - fftSequential.GetCoefficient(i), 1e-3);
+	}
+
+	//Addition, scaling and derivative
+	auto sum = a;
+	sum.Add(Execution::par, a).Scale(Execution::par, 3);
+	auto derivative = a.CalculateDerivative(Execution::par);
+	auto expected = a.CalculateDerivative();
+
+	BOOST_REQUIRE_EQUAL(sum.Size(), a.Size());
+	BOOST_REQUIRE_EQUAL(derivative.Size(), expected.Size());
+	for (unsigned int i = 0; i + 1 < a.Size(); i += 101)
+	{
+		BOOST_CHECK_EQUAL(sum.GetCoefficient(i), 6 * a.GetCoefficient(i));
+		BOOST_CHECK_EQUAL(derivative.GetCoefficient(i), expected.GetCoefficient(i));
+	}
+}
+
+BOOST_AUTO_TEST_CASE(Modular_Arithmetic)
+{
+	typedef ModInt<998244353> F;
+
+	BOOST_CHECK_EQUAL(F(-1).Value(), 998244352u);
+	BOOST_CHECK(F(3) * F(3).Inverse() == F(1));
+	BOOST_CHECK(F(2).Pow(23) == F(8388608));
+
+	//(x + 1)(x - 1) = x^2 - 1, and back by division
+	Polynomial<F> a{ 1, 1 };
+	Polynomial<F> b{ -1, 1 };
+	auto product = a * b;
+	BOOST_CHECK(product.GetCoefficient(0) == F(-1));
+	BOOST_CHECK(product.GetCoefficient(1) == F(0));
+	BOOST_CHECK(product.GetCoefficient(2) == F(1));
+	BOOST_CHECK((product / b).GetCoefficient(0) == F(1));
+
+	//Integral of 3x^2 over [0, 2] is 8, exactly
+	Polynomial<F> square{ 0, 0, 3 };
+	BOOST_CHECK(square.CalculateIntegral(0, 2) == F(8));
+
+	std::ostringstream text;
+	text << product;
+	BOOST_CHECK_EQUAL(text.str(), "P(x) = 1x^2 + 0x + 998244352");
+
+	BOOST_CHECK_THROW(product.FindRoots(), std::domain_error);
+}
+
+template <typename F> void CheckNttProduct(const std::size_t size)
+{
+	Polynomial<F> a;
+	Polynomial<F> b;
+	for (unsigned int i = 0; i < size; i++)
+	{
+		a.SetCoefficient(F(static_cast<long long>(i) * 7919 - 123456789), i);
+		b.SetCoefficient(F(static_cast<long long>(i) * i * 104729 + 5), i);
+	}
+
+	const auto thresholds = Polynomial<F>::GetMultiplicationThresholds();
+	auto fast = a * b;
+
+	Polynomial<F>::SetMultiplicationThresholds({ std::numeric_limits<std::size_t>::max(), std::numeric_limits<std::size_t>::max() });
+	auto schoolbook = a * b;
+	Polynomial<F>::SetMultiplicationThresholds(thresholds);
+
+	BOOST_REQUIRE_EQUAL(fast.Size(), schoolbook.Size());
+	BOOST_CHECK(std::equal(fast.Data(), fast.Data() + fast.Size(), schoolbook.Data()));
+}
+
+BOOST_AUTO_TEST_CASE(Modular_Ntt)
+{
+	ResetPolynomialStats();
+
+	//Transformed directly, and by CRT over three NTT primes
+	CheckNttProduct<ModInt<998244353>>(3000);
+	CheckNttProduct<ModInt<1000000007>>(3000);
+
+	if (polynomialStatsEnabled)
+	{
+		BOOST_CHECK_EQUAL(GetPolynomialStats().nttMultiplications, 2);
+	}
+}
+
+BOOST_AUTO_TEST_CASE(Integer_Ntt)
+{
+	ResetPolynomialStats();
+
+	//Large integer products are exact, and the NTT agrees with a wide schoolbook reference
+	const unsigned int size = 3000;
+	Polynomial<int> a;
+	Polynomial<int> b;
+	for (unsigned int i = 0; i < size; i++)
+	{
+		a.SetCoefficient(static_cast<int>(i * 7919 % 2001) - 1000, i);
+		b.SetCoefficient(static_cast<int>(i * 104729 % 1999) - 999, i);
+	}
+
+	auto product = a * b;
+	BOOST_REQUIRE_EQUAL(product.Size(), 2 * size - 1);
+
+	auto expected = std::vector<long long>(2 * size - 1);
+	for (unsigned int i = 0; i < size; i++)
+	{
+		for (unsigned int j = 0; j < size; j++)
+		{
+			expected[i + j] += static_cast<long long>(a.GetCoefficient(i)) * b.GetCoefficient(j);
+		}
+	}
+
+	for (std::size_t i = 0; i < expected.size(); i++)
+	{
+		BOOST_CHECK_EQUAL(product.GetCoefficient(static_cast<unsigned int>(i)), expected[i]);
+	}
+
+	if (polynomialStatsEnabled)
+	{
+		BOOST_CHECK_EQUAL(GetPolynomialStats().nttMultiplications, 1);
+	}
+
+	//Products that overflow throw, small and large
+	Polynomial<int> largest{ std::numeric_limits<int>::max() };
+	BOOST_CHECK_THROW(largest * Polynomial<int>{ 2 }, std::overflow_error);
+
+	Polynomial<int> big;
+	for (unsigned int i = 0; i < size; i++)
+	{
+		big.SetCoefficient(50000, i);
+	}
+	BOOST_CHECK_THROW(big * big, std::overflow_error);
+
+	//A large bound whose coefficients still fit, down to the smallest int
+	Polynomial<int> c{ 40000, 40000 };
+	Polynomial<int> d{ 40000, -40000 };
+	auto fits = c * d;
+	BOOST_CHECK_EQUAL(fits.GetCoefficient(0), 1600000000);
+	BOOST_CHECK_EQUAL(fits.GetCoefficient(1), 0);
+	BOOST_CHECK_EQUAL(fits.GetCoefficient(2), -1600000000);
+
+	auto smallest = Polynomial<int>{ -65536 } * Polynomial<int>{ 32768 };
+	BOOST_CHECK_EQUAL(smallest.GetCoefficient(0), std::numeric_limits<int>::min());
+
+	//Sparse products that may overflow are checked too
+	Polynomial<int> sparse(100000, 5000);
+	BOOST_CHECK_THROW(sparse * sparse, std::overflow_error);
+}
+
+BOOST_AUTO_TEST_CASE(Chebyshev_Evaluation)
+{
+	//1 + 2 T_1 + 3 T_2 = 6t^2 + 2t - 2
+	ChebyshevPolynomial<double> c{ 1, 2, 3 };
+	BOOST_CHECK_CLOSE(c.ValueAt(0.3), 6 * 0.09 + 0.6 - 2, 1e-12);
+
+	//Batch evaluation of a degree 63 approximation of exp on [0, 1] against single points
+	auto f = ChebyshevPolynomial<double>::FromFunction([](const double x) { return std::exp(x); }, 64, 0, 1);
+	BOOST_CHECK_EQUAL(f.Size(), 64);
+
+	auto x = std::vector<double>(101);
+	auto y = std::vector<double>(x.size());
+	for (std::size_t i = 0; i < x.size(); i++)
+	{
+		x[i] = static_cast<double>(i) / 100;
+	}
+
+	f.ValueAtRange(x.data(), x.data() + x.size(), y.data());
+	for (std::size_t i = 0; i < x.size(); i++)
+	{
+		BOOST_CHECK_SMALL(y[i] - std::exp(x[i]), 1e-14);
+		BOOST_CHECK_SMALL(y[i] - f.ValueAt(x[i]), 1e-14);
+	}
+
+	BOOST_CHECK_THROW(ChebyshevPolynomial<double>({ 1 }, 1, 1), std::invalid_argument);
+}
+
+BOOST_AUTO_TEST_CASE(Chebyshev_Conversion)
+{
+	Polynomial<double> p{ 1, -2, 0, 3, 1 };
+
+	//Round trip on [0, 2]
+	auto c = ChebyshevPolynomial<double>::FromPolynomial(p, 0, 2);
+	BOOST_REQUIRE_EQUAL(c.Size(), p.Size());
+	BOOST_CHECK_CLOSE(c.ValueAt(1.5), p.ValueAt(1.5), 1e-10);
+
+	auto back = c.ToPolynomial();
+	BOOST_REQUIRE_EQUAL(back.Size(), p.Size());
+	for (unsigned int i = 0; i < p.Size(); i++)
+	{
+		BOOST_CHECK_SMALL(back.GetCoefficient(i) - p.GetCoefficient(i), 1e-12);
+	}
+
+	//Derivative and integral in the Chebyshev basis
+	auto derivative = c.CalculateDerivative();
+	auto expected = p.CalculateDerivative();
+	BOOST_CHECK_EQUAL(derivative.Size(), p.Size() - 1);
+	BOOST_CHECK_CLOSE(derivative.ValueAt(0.7), expected.ValueAt(0.7), 1e-10);
+
+	BOOST_CHECK_SMALL(c.CalculateAntiderivative().ValueAt(0), 1e-14);
+	BOOST_CHECK_CLOSE(c.CalculateIntegral(0.5, 1.75), p.CalculateIntegral(0.5, 1.75), 1e-10);
+
+	//Large conversions go through the divide and conquer basis change, with FFT products at the top
+	Polynomial<double> large;
+	for (unsigned int i = 0; i < 600; i++)
+	{
+		large.SetCoefficient(static_cast<double>(static_cast<int>(i * 7919 % 201) - 100) / 100, i);
+	}
+
+	auto largeChebyshev = ChebyshevPolynomial<double>::FromPolynomial(large);
+	BOOST_REQUIRE_EQUAL(largeChebyshev.Size(), large.Size());
+	for (double x = -1; x <= 1; x += 0.125)
+	{
+		BOOST_CHECK_SMALL(largeChebyshev.ValueAt(x) - large.ValueAt(x), 1e-9);
+	}
+
+	//The monomial direction loses about 2^n in accuracy, so it is only checked at a moderate size past the leaves
+	Polynomial<double> moderate;
+	for (unsigned int i = 0; i < 40; i++)
+	{
+		moderate.SetCoefficient(static_cast<double>(static_cast<int>(i * 31 % 17) - 8) / 8, i);
+	}
+
+	auto moderateBack = ChebyshevPolynomial<double>::FromPolynomial(moderate).ToPolynomial();
+	BOOST_REQUIRE_EQUAL(moderateBack.Size(), moderate.Size());
+	for (unsigned int i = 0; i < moderate.Size(); i++)
+	{
+		BOOST_CHECK_SMALL(moderateBack.GetCoefficient(i) - moderate.GetCoefficient(i), 1e-6);
+	}
+
+	//Single precision keeps its accuracy at degree 40, where the monomial coefficients of T_40 reach 10^15
+	auto g = ChebyshevPolynomial<float>::FromFunction([](const float x) { return std::sin(6 * x); }, 40);
+	BOOST_CHECK_SMALL(g.ValueAt(0.25f) - std::sin(1.5f), 1e-5f);
+}